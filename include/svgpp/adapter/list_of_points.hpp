@@ -9,6 +9,7 @@
 
 #include <svgpp/definitions.hpp>
 #include <svgpp/detail/adapt_context.hpp>
+#include <boost/range/iterator_range.hpp>
 
 namespace svgpp
 {
@@ -34,6 +35,24 @@ struct list_of_points_to_path_adapter<tag::element::polyline>
       path_events::policy::path_exit(path_context);
     }
   }
+
+  // policy::list_of_points::flat_coordinates
+  template<class Context, class Coordinate>
+  static void set(Context & context, tag::attribute::points, tag::source::attribute, 
+    boost::iterator_range<Coordinate const *> const & r)
+  {
+    typedef detail::unwrap_context<Context, tag::path_events_policy> path_events;
+
+    typename path_events::type & path_context = path_events::get(context);
+    Coordinate const * it = r.begin(), * const end = r.end();
+    if (it != end)
+    {
+      path_events::policy::path_move_to(path_context, it[0], it[1], tag::coordinate::absolute());
+      for(it += 2; it != end; it += 2)
+        path_events::policy::path_line_to(path_context, it[0], it[1], tag::coordinate::absolute());
+      path_events::policy::path_exit(path_context);
+    }
+  }
 };
 
 template<>
@@ -62,6 +81,28 @@ struct list_of_points_to_path_adapter<tag::element::polygon>
       }
     }
   }
+
+  // policy::list_of_points::flat_coordinates
+  template<class Context, class Coordinate>
+  static void set(Context & context, tag::attribute::points, tag::source::attribute, 
+    boost::iterator_range<Coordinate const *> const & r)
+  {
+    typedef detail::unwrap_context<Context, tag::path_events_policy> path_events;
+
+    typename path_events::type & path_context = path_events::get(context);
+    Coordinate const * it = r.begin(), * const end = r.end();
+    if (it != end)
+    {
+      path_events::policy::path_move_to(path_context, it[0], it[1], tag::coordinate::absolute());
+      if (end - it > 2)
+      {
+        for(it += 2; it != end; it += 2)
+          path_events::policy::path_line_to(path_context, it[0], it[1], tag::coordinate::absolute());
+        path_events::policy::path_close_subpath(path_context);
+        path_events::policy::path_exit(path_context);
+      }
+    }
+  }
 };
 
 }
\ No newline at end of file
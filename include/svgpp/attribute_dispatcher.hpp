@@ -35,6 +35,8 @@
 #include <boost/type_traits.hpp>
 #include <boost/parameter.hpp>
 #include <boost/preprocessor.hpp>
+#include <boost/range/iterator_range.hpp>
+#include <string>
 
 namespace svgpp
 {
@@ -43,6 +45,7 @@ BOOST_PARAMETER_TEMPLATE_KEYWORD(basic_shapes_policy)
 BOOST_PARAMETER_TEMPLATE_KEYWORD(ignored_attributes)
 BOOST_PARAMETER_TEMPLATE_KEYWORD(processed_attributes)
 BOOST_PARAMETER_TEMPLATE_KEYWORD(passthrough_attributes)
+BOOST_PARAMETER_TEMPLATE_KEYWORD(deferred_attributes)
 BOOST_PARAMETER_TEMPLATE_KEYWORD(referencing_element)
 BOOST_PARAMETER_TEMPLATE_KEYWORD(viewport_policy)
 
@@ -96,7 +99,8 @@ public:
   typename boost::enable_if<typename boost::mpl::apply<typename Loader::is_attribute_processed, AttributeTag>::type>::type
   operator()(AttributeTag tag) 
   {
-    result_ = loader_.load_attribute_value(tag, attributeValue_, PropertySource());
+    result_ = load(tag, 
+      boost::mpl::bool_<boost::mpl::has_key<typename Loader::deferred_attributes, AttributeTag>::value>());
   }
 
   bool succeeded() const 
@@ -105,6 +109,18 @@ public:
   }
 
 private:
+  template<class AttributeTag>
+  bool load(AttributeTag tag, boost::mpl::false_)
+  {
+    return loader_.load_attribute_value(tag, attributeValue_, PropertySource());
+  }
+
+  template<class AttributeTag>
+  bool load(AttributeTag tag, boost::mpl::true_)
+  {
+    return loader_.load_deferred_attribute_value(tag, attributeValue_, PropertySource());
+  }
+
   Loader & loader_;
   AttributeValue const & attributeValue_;
   bool result_;
@@ -237,6 +253,51 @@ template<class ElementTag, class Context,
   SVGPP_TEMPLATE_ARGS_DEF>
 class attribute_dispatcher;
 
+// Passed instead of parsed value for attributes listed in deferred_attributes.
+// Keeps unparsed attribute value, that is parsed and passed to context only when parse() is called.
+// AttributeValue range passed by XML policy may reference temporary buffer (e.g. libxml2 attribute value
+// with entity references), so the value is copied and the object doesn't depend on XML document lifetime.
+// Adapters that depend on other attributes of the element (basic shapes, viewport, markers) aren't applied
+template<class ElementTag, class AttributeTag, class AttributeValue, class PropertySource, SVGPP_TEMPLATE_ARGS_DEF>
+class deferred_attribute_value
+{
+public:
+  typedef AttributeTag attribute_tag;
+  typedef PropertySource property_source;
+  typedef typename boost::range_value<AttributeValue>::type char_type;
+  typedef std::basic_string<char_type> string_type;
+  typedef boost::iterator_range<typename string_type::const_iterator> raw_value_type;
+
+  deferred_attribute_value(AttributeValue const & value)
+    : value_(boost::begin(value), boost::end(value))
+  {}
+
+  static BOOST_CONSTEXPR detail::attribute_id attribute_id() 
+  { 
+    return AttributeTag::attribute_id; 
+  }
+
+  raw_value_type raw_value() const 
+  { 
+    return raw_value_type(value_.begin(), value_.end()); 
+  }
+
+  template<class Context>
+  bool parse(Context & context) const
+  {
+    typedef typename boost::parameter::parameters<
+      boost::parameter::optional<tag::path_policy>,
+      boost::parameter::optional<tag::path_events_policy>
+    >::template bind<SVGPP_TEMPLATE_ARGS_PASS>::type args_t;
+    detail::bind_context_parameters_wrapper<Context, args_t> bound_context(context);
+    return value_parser<typename traits::attribute_type<ElementTag, AttributeTag>::type, 
+        SVGPP_TEMPLATE_ARGS_PASS>::parse(AttributeTag(), bound_context, raw_value(), PropertySource());
+  }
+
+private:
+  string_type value_;
+};
+
 template<class ElementTag, class Context, SVGPP_TEMPLATE_ARGS>
 class attribute_dispatcher_base: boost::noncopyable
 {
@@ -251,6 +312,7 @@ protected:
       boost::parameter::optional<tag::ignored_attributes, boost::mpl::is_sequence<boost::mpl::_> >
     , boost::parameter::optional<tag::processed_attributes, boost::mpl::is_sequence<boost::mpl::_> >
     , boost::parameter::optional<tag::passthrough_attributes, boost::mpl::is_sequence<boost::mpl::_> >
+    , boost::parameter::optional<tag::deferred_attributes, boost::mpl::is_sequence<boost::mpl::_> >
     , boost::parameter::optional<tag::length_policy>
     , boost::parameter::optional<tag::basic_shapes_policy>
     , boost::parameter::optional<tag::number_type>
@@ -269,6 +331,8 @@ public:
     typename number_type_by_context<Context>::type>::type coordinate_type;
   typedef typename boost::parameter::value_type<args, tag::passthrough_attributes, 
     boost::mpl::set0<> >::type passthrough_attributes;
+  typedef typename boost::parameter::value_type<args, tag::deferred_attributes, 
+    boost::mpl::set0<> >::type deferred_attributes;
 
   typedef typename
     boost::mpl::if_<
@@ -353,6 +417,16 @@ public:
     return true;
   }
 
+  template<class AttributeTag, class AttributeValue, class PropertySource>
+  bool load_deferred_attribute_value(
+    AttributeTag tag, AttributeValue const & attribute_value, 
+    PropertySource property_source)
+  {
+    policy::value_events::default_policy<Context>::set(context_, tag, property_source, 
+      deferred_attribute_value<ElementTag, AttributeTag, AttributeValue, PropertySource, SVGPP_TEMPLATE_ARGS_PASS>(attribute_value));
+    return true;
+  }
+
   template<class EventTag>
   bool notify(EventTag event_tag)
   {
@@ -735,7 +809,8 @@ public:
       boost::parameter::optional<tag::path_policy>,
       boost::parameter::optional<tag::path_events_policy>,
       boost::parameter::optional<tag::markers_policy>,
-      boost::parameter::optional<tag::marker_events_policy>
+      boost::parameter::optional<tag::marker_events_policy>,
+      boost::parameter::optional<tag::list_of_points_policy>
     >::template bind<SVGPP_TEMPLATE_ARGS_PASS>::type args2_t;
     typedef bind_context_parameters_wrapper<Context, args2_t> context_t;
     typedef path_adapter_if_needed<context_t> path_adapter_t; 
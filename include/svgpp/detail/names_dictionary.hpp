@@ -129,10 +129,28 @@ private:
     }
   };
 
+  // Dictionaries used with find_ignore_case contain only lower case ASCII keys
+  // (see lower_case_values), so ASCII case folding is enough and no std::locale
+  // lookups are made per character
+  struct ascii_iless
+  {
+    template<class Char>
+    static Char to_lower(Char ch)
+    {
+      return ch >= Char('A') && ch <= Char('Z') ? Char(ch - Char('A') + Char('a')) : ch;
+    }
+
+    template<class Char>
+    bool operator()(Char lhs, Char rhs) const
+    {
+      return to_lower(lhs) < to_lower(rhs);
+    }
+  };
+
   struct key_iless
   {
   private:
-    boost::algorithm::is_iless is_iless_;
+    ascii_iless is_iless_;
 
   public:
     template<class Range, class Char>
@@ -20,6 +20,7 @@
 #include <boost/parameter.hpp>
 #include <boost/static_assert.hpp>
 #include <boost/preprocessor.hpp>
+#include <boost/tti/has_type.hpp>
 #include <boost/tti/member_type.hpp>
 #include <boost/type_traits.hpp>
 
@@ -52,6 +53,34 @@ namespace detail
   {
     return true;
   }
+
+  BOOST_TTI_HAS_TYPE(tracks_current_element)
+
+  // Lets error policy know which element attribute errors belong to
+  template<class ErrorPolicy, class Context, class XMLElement, class Enable = void>
+  struct current_element_guard
+  {
+    current_element_guard(Context const &, XMLElement const &) {}
+  };
+
+  template<class ErrorPolicy, class Context, class XMLElement>
+  struct current_element_guard<ErrorPolicy, Context, XMLElement,
+    typename boost::enable_if<has_type_tracks_current_element<ErrorPolicy> >::type>
+  {
+    current_element_guard(Context const & context, XMLElement const & element)
+      : context_(context)
+    {
+      ErrorPolicy::on_enter_attributes(context, element);
+    }
+
+    ~current_element_guard()
+    {
+      ErrorPolicy::on_exit_attributes(context_);
+    }
+
+  private:
+    Context const & context_;
+  };
 }
 
 BOOST_PARAMETER_TEMPLATE_KEYWORD(context_factories)
@@ -97,6 +126,25 @@ public:
     return load_expected_element(xml_element_svg, context, tag::element::svg());
   }
 
+  // Only attributes of root 'svg' element are processed, element content isn't accessed
+  template<class XMLElement, class Context>
+  static bool load_document_attributes(XMLElement const & xml_element_svg, Context & context)
+  {
+    typedef typename boost::parameter::value_type<args, tag::xml_element_policy, 
+      policy::xml::element_iterator<XMLElement> >::type xml_policy_t;
+    typedef typename boost::parameter::value_type<args, tag::error_policy, 
+      policy::error::default_policy<Context> >::type error_policy;
+
+    typename xml_policy_t::element_name_type element_name = xml_policy_t::get_local_name(xml_element_svg);
+    detail::element_type_id element_type_id = detail::element_name_to_id_dictionary::find(
+      xml_policy_t::get_string_range(element_name));
+    if (element_type_id == detail::unknown_element_type_id)
+      return error_policy::unknown_element(context, xml_element_svg, xml_policy_t::get_string_range(element_name));
+    if (element_type_id != detail::element_type_id_svg)
+      return error_policy::unexpected_element(context, xml_element_svg);
+    return load_attributes<void>(xml_element_svg, context, tag::element::svg());
+  }
+
   template<class XMLElement, class Context, class ElementTag>
   static bool load_expected_element(XMLElement const & xml_element, Context & context, ElementTag expected_element)
   {
@@ -165,6 +213,9 @@ public:
       referencing_element<referencing_element_tag>,
       SVGPP_TEMPLATE_ARGS2_PASS
     > attribute_dispatcher_t;
+    typedef typename boost::parameter::value_type<args, tag::error_policy, 
+      policy::error::default_policy<Context> >::type error_policy;
+    detail::current_element_guard<error_policy, Context, XMLElement> current_element(context, xml_element);
     attribute_dispatcher_t attribute_dispatcher(context);
     if (!attribute_traversal<
         ElementTag,
@@ -213,9 +264,10 @@ public:
     for(typename xml_policy_t::iterator_type xml_child_element = xml_policy_t::get_child_elements(xml_element); 
       !xml_policy_t::is_end(xml_child_element); xml_policy_t::advance_element(xml_child_element))
     {
-      if (!load_child_xml_element<ExpectedChildElements, is_element_processed, void>(
-          xml_child_element, context, element_tag))
-        return false;
+      if (traversal_control_policy::process_child(context, xml_child_element))
+        if (!load_child_xml_element<ExpectedChildElements, is_element_processed, void>(
+            xml_child_element, context, element_tag))
+          return false;
       if (!traversal_control_policy::proceed_to_next_child(context))
         break;
     }
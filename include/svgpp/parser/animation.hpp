@@ -10,8 +10,10 @@
 #include <svgpp/config.hpp>
 #include <svgpp/parser/value_parser_fwd.hpp>
 #include <svgpp/parser/detail/value_parser_parameters.hpp>
-#include <svgpp/parser/grammar/clock_value.hpp>
-#include <boost/spirit/include/qi.hpp>
+#include <svgpp/parser/external_function/parse_clock_value.hpp>
+#if !defined(SVGPP_USE_EXTERNAL_CLOCK_VALUE_PARSER)
+# include <svgpp/parser/external_function/parse_clock_value_impl.hpp>
+#endif
 
 namespace svgpp
 {
@@ -23,16 +25,13 @@ struct value_parser<tag::type::clock_value, SVGPP_TEMPLATE_ARGS_PASS>
   static bool parse(AttributeTag tag, Context & context, AttributeValue const & attribute_value, 
                                     tag::source::attribute source)
   {
-    namespace qi = boost::spirit::qi;
-
     typedef typename boost::range_const_iterator<AttributeValue>::type iterator_t;
     typedef detail::value_parser_parameters<Context, SVGPP_TEMPLATE_ARGS_PASS> args_t;
 
     iterator_t it = boost::begin(attribute_value), end = boost::end(attribute_value);
     // TODO: own type for clock_value
-    SVGPP_STATIC_IF_SAFE const clock_value_grammar<iterator_t, typename args_t::number_type> grammar;
     typename args_t::number_type value;
-    if (qi::parse(it, end, grammar, value) && it == end)
+    if (detail::parse_clock_value(it, end, value) && it == end)
     {
       args_t::value_events_policy::set(args_t::value_events_context::get(context), tag, source, value);
       return true;
@@ -7,8 +7,12 @@
 
 #pragma once
 
+#include <svgpp/parser/external_function/parse_clock_value_impl.hpp>
 #include <svgpp/parser/external_function/parse_color_impl.hpp>
+#include <svgpp/parser/external_function/parse_iri_impl.hpp>
 #include <svgpp/parser/external_function/parse_length_impl.hpp>
+#include <svgpp/parser/external_function/parse_list_of_numbers_impl.hpp>
+#include <svgpp/parser/external_function/parse_list_of_points_impl.hpp>
 #include <svgpp/parser/external_function/parse_misc_impl.hpp>
 #include <svgpp/parser/external_function/parse_paint_impl.hpp>
 #include <svgpp/parser/external_function/parse_path_data_impl.hpp>
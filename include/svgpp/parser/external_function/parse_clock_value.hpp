@@ -0,0 +1,16 @@
+// Copyright Oleg Maximenko 2016.
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//
+// See http://github.com/svgpp/svgpp for library home page.
+
+#pragma once
+
+namespace svgpp { namespace detail 
+{
+
+template<class Iterator, class Number>
+bool parse_clock_value(Iterator & it, Iterator end, Number & value);
+
+}}
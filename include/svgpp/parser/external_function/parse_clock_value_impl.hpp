@@ -0,0 +1,29 @@
+// Copyright Oleg Maximenko 2016.
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//
+// See http://github.com/svgpp/svgpp for library home page.
+
+#pragma once
+
+#include <boost/spirit/include/qi.hpp>
+#include <svgpp/config.hpp>
+#include <svgpp/parser/external_function/parse_clock_value.hpp>
+#include <svgpp/parser/grammar/clock_value.hpp>
+
+#define SVGPP_PARSE_CLOCK_VALUE_IMPL(IteratorType, NumberType) \
+  template bool svgpp::detail::parse_clock_value<IteratorType, NumberType>( \
+    IteratorType &, IteratorType, NumberType &);
+
+namespace svgpp { namespace detail 
+{
+
+template<class Iterator, class Number>
+bool parse_clock_value(Iterator & it, Iterator end, Number & value)
+{
+  SVGPP_STATIC_IF_SAFE const clock_value_grammar<Iterator, Number> grammar;
+  return boost::spirit::qi::parse(it, end, grammar, value);
+}
+
+}}
@@ -0,0 +1,21 @@
+// Copyright Oleg Maximenko 2016.
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//
+// See http://github.com/svgpp/svgpp for library home page.
+
+#pragma once
+
+#include <boost/range/iterator_range.hpp>
+
+namespace svgpp { namespace detail 
+{
+
+template<class Iterator>
+bool parse_iri(Iterator & it, Iterator end, boost::iterator_range<Iterator> & iri);
+
+template<class PropertySource, class Iterator>
+bool parse_funciri(Iterator & it, Iterator end, boost::iterator_range<Iterator> & iri);
+
+}}
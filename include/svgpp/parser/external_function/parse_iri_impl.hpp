@@ -0,0 +1,41 @@
+// Copyright Oleg Maximenko 2016.
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//
+// See http://github.com/svgpp/svgpp for library home page.
+
+#pragma once
+
+#include <boost/spirit/include/qi.hpp>
+#include <svgpp/config.hpp>
+#include <svgpp/definitions.hpp>
+#include <svgpp/parser/external_function/parse_iri.hpp>
+#include <svgpp/parser/grammar/iri.hpp>
+
+#define SVGPP_PARSE_IRI_IMPL(IteratorType) \
+  template bool svgpp::detail::parse_iri<IteratorType>( \
+    IteratorType &, IteratorType, boost::iterator_range<IteratorType> &); \
+  template bool svgpp::detail::parse_funciri<svgpp::tag::source::attribute, IteratorType>( \
+    IteratorType &, IteratorType, boost::iterator_range<IteratorType> &); \
+  template bool svgpp::detail::parse_funciri<svgpp::tag::source::css, IteratorType>( \
+    IteratorType &, IteratorType, boost::iterator_range<IteratorType> &);
+
+namespace svgpp { namespace detail 
+{
+
+template<class Iterator>
+bool parse_iri(Iterator & it, Iterator end, boost::iterator_range<Iterator> & iri)
+{
+  SVGPP_STATIC_IF_SAFE const iri_grammar<Iterator> grammar;
+  return boost::spirit::qi::parse(it, end, grammar, iri);
+}
+
+template<class PropertySource, class Iterator>
+bool parse_funciri(Iterator & it, Iterator end, boost::iterator_range<Iterator> & iri)
+{
+  SVGPP_STATIC_IF_SAFE const funciri_grammar<PropertySource, Iterator> grammar;
+  return boost::spirit::qi::parse(it, end, grammar, iri);
+}
+
+}}
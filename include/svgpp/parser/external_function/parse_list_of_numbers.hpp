@@ -0,0 +1,19 @@
+// Copyright Oleg Maximenko 2016.
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//
+// See http://github.com/svgpp/svgpp for library home page.
+
+#pragma once
+
+#include <vector>
+
+namespace svgpp { namespace detail 
+{
+
+// In case of error valid numbers from the beginning of list are left in numbers
+template<class Iterator, class PropertySource, class Number>
+bool parse_list_of_numbers(Iterator it, Iterator end, PropertySource, std::vector<Number> & numbers);
+
+}}
@@ -0,0 +1,49 @@
+// Copyright Oleg Maximenko 2016.
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//
+// See http://github.com/svgpp/svgpp for library home page.
+
+#pragma once
+
+#include <boost/spirit/include/qi.hpp>
+#include <svgpp/config.hpp>
+#include <svgpp/definitions.hpp>
+#include <svgpp/parser/detail/common.hpp>
+#include <svgpp/parser/external_function/parse_list_of_numbers.hpp>
+
+#define SVGPP_PARSE_LIST_OF_NUMBERS_IMPL(IteratorType, NumberType) \
+  template bool svgpp::detail::parse_list_of_numbers<IteratorType, svgpp::tag::source::attribute, NumberType>( \
+    IteratorType, IteratorType, svgpp::tag::source::attribute, std::vector<NumberType> &); \
+  template bool svgpp::detail::parse_list_of_numbers<IteratorType, svgpp::tag::source::css, NumberType>( \
+    IteratorType, IteratorType, svgpp::tag::source::css, std::vector<NumberType> &);
+
+namespace svgpp { namespace detail 
+{
+
+template<class Iterator, class PropertySource, class Number>
+bool parse_list_of_numbers(Iterator it, Iterator end, PropertySource, std::vector<Number> & numbers)
+{
+  namespace qi = boost::spirit::qi;
+
+  SVGPP_STATIC_IF_SAFE const qi::real_parser<Number, detail::number_policies<Number, PropertySource> > number;
+  SVGPP_STATIC_IF_SAFE const comma_wsp_rule_no_skip<Iterator> comma_wsp;
+
+  Number value;
+  if (it == end)
+    return true;
+  if (!qi::parse(it, end, number, value))
+    return false;
+  numbers.push_back(value);
+  for(;;)
+  {
+    if (it == end)
+      return true;
+    if (!qi::parse(it, end, comma_wsp >> number, value))
+      return false;
+    numbers.push_back(value);
+  }
+}
+
+}}
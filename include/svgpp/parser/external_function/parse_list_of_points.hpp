@@ -0,0 +1,20 @@
+// Copyright Oleg Maximenko 2016.
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//
+// See http://github.com/svgpp/svgpp for library home page.
+
+#pragma once
+
+#include <vector>
+
+namespace svgpp { namespace detail 
+{
+
+// Parses whole <list-of-points> to the flat array of coordinates without per-item function calls. 
+// Like parse_list_iterator, in case of error valid points from the beginning of list are left in coordinates
+template<class Iterator, class Coordinate>
+bool parse_list_of_points_to_array(Iterator it, Iterator end, std::vector<Coordinate> & coordinates);
+
+}}
@@ -0,0 +1,55 @@
+// Copyright Oleg Maximenko 2016.
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//
+// See http://github.com/svgpp/svgpp for library home page.
+
+#pragma once
+
+#include <boost/spirit/include/qi.hpp>
+#include <svgpp/config.hpp>
+#include <svgpp/parser/detail/common.hpp>
+#include <svgpp/parser/external_function/parse_list_of_points.hpp>
+
+#define SVGPP_PARSE_LIST_OF_POINTS_IMPL(IteratorType, CoordinateType) \
+  template bool svgpp::detail::parse_list_of_points_to_array<IteratorType, CoordinateType>( \
+    IteratorType, IteratorType, std::vector<CoordinateType> &);
+
+namespace svgpp { namespace detail 
+{
+
+template<class Iterator, class Coordinate>
+bool parse_list_of_points_to_array(Iterator it, Iterator end, std::vector<Coordinate> & coordinates)
+{
+  namespace qi = boost::spirit::qi;
+
+  SVGPP_STATIC_IF_SAFE const qi::real_parser<Coordinate, real_policies_without_inf_nan<Coordinate> > number;
+  SVGPP_STATIC_IF_SAFE const comma_wsp_rule_no_skip<Iterator> comma_wsp;
+
+  qi::parse(it, end, *character_encoding_namespace::space);
+  if (it == end)
+    return true;
+  Coordinate x, y;
+  if (!qi::parse(it, end, number >> (comma_wsp | &qi::lit('-')) >> number, x, y))
+    return false;
+  coordinates.push_back(x);
+  coordinates.push_back(y);
+  for(;;)
+  {
+    Iterator item_start = it;
+    if (qi::parse(it, end, comma_wsp >> number >> (comma_wsp | &qi::lit('-')) >> number, x, y))
+    {
+      coordinates.push_back(x);
+      coordinates.push_back(y);
+    }
+    else
+    {
+      it = item_start;
+      qi::parse(it, end, *character_encoding_namespace::space);
+      return it == end;
+    }
+  }
+}
+
+}}
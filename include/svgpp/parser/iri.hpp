@@ -11,7 +11,10 @@
 #include <svgpp/parser/value_parser_fwd.hpp>
 #include <svgpp/parser/detail/pass_iri_value.hpp>
 #include <svgpp/parser/detail/value_parser_parameters.hpp>
-#include <svgpp/parser/grammar/iri.hpp>
+#include <svgpp/parser/external_function/parse_iri.hpp>
+#if !defined(SVGPP_USE_EXTERNAL_IRI_PARSER)
+# include <svgpp/parser/external_function/parse_iri_impl.hpp>
+#endif
 
 namespace svgpp
 {
@@ -19,7 +22,25 @@ namespace svgpp
 namespace detail
 {
 
-template<class GetGrammarMetafunction, SVGPP_TEMPLATE_ARGS>
+struct parse_iri_function
+{
+  template<class PropertySource, class Iterator>
+  static bool parse(Iterator & it, Iterator end, boost::iterator_range<Iterator> & iri)
+  {
+    return parse_iri(it, end, iri);
+  }
+};
+
+struct parse_funciri_function
+{
+  template<class PropertySource, class Iterator>
+  static bool parse(Iterator & it, Iterator end, boost::iterator_range<Iterator> & iri)
+  {
+    return parse_funciri<PropertySource>(it, end, iri);
+  }
+};
+
+template<class ParseFunction, SVGPP_TEMPLATE_ARGS>
 struct iri_value_parser
 {
   template<class AttributeTag, class Context, class AttributeValue, class PropertySource>
@@ -33,10 +54,9 @@ struct iri_value_parser
     typedef typename detail::unwrap_context<Context, tag::iri_policy>::template bind<args2_t>::type iri_policy_t;
     typedef typename boost::range_const_iterator<AttributeValue>::type iterator_t;
 
-    SVGPP_STATIC_IF_SAFE typename GetGrammarMetafunction::template apply<PropertySource, iterator_t>::type iri_rule;
     boost::iterator_range<iterator_t> iri;
     iterator_t it = boost::begin(attribute_value), end = boost::end(attribute_value);
-    if (qi::parse(it, end, iri_rule, iri) && it == end)
+    if (ParseFunction::template parse<PropertySource>(it, end, iri) && it == end)
     {
       typedef typename value_events_with_iri_policy<
         typename args_t::value_events_policy, 
@@ -56,13 +76,13 @@ struct iri_value_parser
 
 template<SVGPP_TEMPLATE_ARGS>
 struct value_parser<tag::type::iri, SVGPP_TEMPLATE_ARGS_PASS>
-  : detail::iri_value_parser<boost::mpl::bind1<boost::mpl::quote1<iri_grammar>, boost::mpl::_2>, SVGPP_TEMPLATE_ARGS_PASS>
+  : detail::iri_value_parser<detail::parse_iri_function, SVGPP_TEMPLATE_ARGS_PASS>
 {
 };
 
 template<SVGPP_TEMPLATE_ARGS>
 struct value_parser<tag::type::funciri, SVGPP_TEMPLATE_ARGS_PASS>
-  : detail::iri_value_parser<boost::mpl::quote2<funciri_grammar>, SVGPP_TEMPLATE_ARGS_PASS>
+  : detail::iri_value_parser<detail::parse_funciri_function, SVGPP_TEMPLATE_ARGS_PASS>
 {
 };
 
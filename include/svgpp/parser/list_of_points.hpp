@@ -12,8 +12,15 @@
 #include <svgpp/parser/detail/finite_function_iterator.hpp>
 #include <svgpp/parser/detail/parse_list_iterator.hpp>
 #include <svgpp/parser/detail/value_parser_parameters.hpp>
-#include <svgpp/parser/grammar/coordinate_pair.hpp>
+#include <svgpp/parser/external_function/parse_list_of_points.hpp>
+#if !defined(SVGPP_USE_EXTERNAL_LIST_OF_POINTS_PARSER)
+# include <svgpp/parser/external_function/parse_list_of_points_impl.hpp>
+# include <svgpp/parser/grammar/coordinate_pair.hpp>
+#endif
 #include <svgpp/parser/value_parser_fwd.hpp>
+#include <svgpp/policy/list_of_points.hpp>
+#include <boost/range/iterator_range.hpp>
+#include <vector>
 
 namespace svgpp 
 {
@@ -24,6 +31,67 @@ struct value_parser<tag::attribute::points, SVGPP_TEMPLATE_ARGS_PASS>
   template<class Context, class AttributeValue>
   static bool parse(tag::attribute::points tag, Context & context, AttributeValue const & attribute_value, 
                                     tag::source::attribute property_source)
+  {
+    typedef typename boost::parameter::parameters<
+      boost::parameter::optional<tag::list_of_points_policy>
+    >::template bind<SVGPP_TEMPLATE_ARGS_PASS>::type args2_t;
+    typedef typename detail::unwrap_context<Context, tag::list_of_points_policy>::template bind<args2_t>::type 
+      list_of_points_policy;
+
+    return parse(tag, context, attribute_value, property_source, 
+      boost::mpl::bool_<list_of_points_policy::coordinate_array>());
+  }
+
+private:
+  template<class Context, class AttributeValue>
+  static bool parse(tag::attribute::points tag, Context & context, AttributeValue const & attribute_value, 
+                                    tag::source::attribute property_source, boost::mpl::true_ /*coordinate_array*/)
+  {
+    typedef detail::value_parser_parameters<Context, SVGPP_TEMPLATE_ARGS_PASS> args_t;
+    typedef typename args_t::number_type coordinate_t;
+
+    std::vector<coordinate_t> coordinates;
+    coordinates.reserve(boost::size(attribute_value) / 4);
+    bool const ok = detail::parse_list_of_points_to_array(
+      boost::begin(attribute_value), boost::end(attribute_value), coordinates);
+    coordinate_t const * const data = coordinates.empty() ? NULL : &coordinates[0];
+    args_t::value_events_policy::set(args_t::value_events_context::get(context), tag, property_source,
+      boost::iterator_range<coordinate_t const *>(data, data + coordinates.size()));
+    if (!ok)
+      return args_t::error_policy::parse_failed(args_t::error_policy_context::get(context), tag, attribute_value);
+    else
+      return true;
+  }
+
+#if defined(SVGPP_USE_EXTERNAL_LIST_OF_POINTS_PARSER)
+  template<class Context, class AttributeValue>
+  static bool parse(tag::attribute::points tag, Context & context, AttributeValue const & attribute_value, 
+                                    tag::source::attribute property_source, boost::mpl::false_ /*coordinate_array*/)
+  {
+    typedef detail::value_parser_parameters<Context, SVGPP_TEMPLATE_ARGS_PASS> args_t;
+    typedef typename args_t::number_type coordinate_t;
+    typedef std::pair<coordinate_t, coordinate_t> point_t;
+
+    std::vector<coordinate_t> coordinates;
+    coordinates.reserve(boost::size(attribute_value) / 4);
+    bool const ok = detail::parse_list_of_points_to_array(
+      boost::begin(attribute_value), boost::end(attribute_value), coordinates);
+    std::vector<point_t> points;
+    points.reserve(coordinates.size() / 2);
+    for(typename std::vector<coordinate_t>::const_iterator it = coordinates.begin(); it != coordinates.end(); it += 2)
+      points.push_back(point_t(it[0], it[1]));
+    point_t const * const data = points.empty() ? NULL : &points[0];
+    args_t::value_events_policy::set(args_t::value_events_context::get(context), tag, property_source,
+      boost::iterator_range<point_t const *>(data, data + points.size()));
+    if (!ok)
+      return args_t::error_policy::parse_failed(args_t::error_policy_context::get(context), tag, attribute_value);
+    else
+      return true;
+  }
+#else
+  template<class Context, class AttributeValue>
+  static bool parse(tag::attribute::points tag, Context & context, AttributeValue const & attribute_value, 
+                                    tag::source::attribute property_source, boost::mpl::false_ /*coordinate_array*/)
   {
     namespace qi = boost::spirit::qi;
 
@@ -54,6 +122,7 @@ struct value_parser<tag::attribute::points, SVGPP_TEMPLATE_ARGS_PASS>
     else
       return true;
   }
+#endif
 };
 
 }
\ No newline at end of file
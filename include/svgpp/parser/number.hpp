@@ -13,6 +13,10 @@
 #include <svgpp/parser/detail/finite_function_iterator.hpp>
 #include <svgpp/parser/detail/parse_list_iterator.hpp>
 #include <svgpp/parser/detail/value_parser_parameters.hpp>
+#include <svgpp/parser/external_function/parse_list_of_numbers.hpp>
+#if !defined(SVGPP_USE_EXTERNAL_LIST_OF_NUMBERS_PARSER)
+# include <svgpp/parser/external_function/parse_list_of_numbers_impl.hpp>
+#endif
 #include <svgpp/parser/value_parser_fwd.hpp>
 #include <boost/spirit/include/qi.hpp>
 #include <boost/spirit/include/phoenix.hpp>
@@ -54,6 +58,18 @@ struct value_parser<tag::type::list_of<tag::type::number>, SVGPP_TEMPLATE_ARGS_P
   static bool parse(AttributeTag tag, Context & context, AttributeValue const & attribute_value, 
                                     PropertySource property_source)
   {
+#if defined(SVGPP_USE_EXTERNAL_LIST_OF_NUMBERS_PARSER)
+    typedef detail::value_parser_parameters<Context, SVGPP_TEMPLATE_ARGS_PASS> args_t;
+    typedef typename args_t::number_type coordinate_t;
+
+    std::vector<coordinate_t> numbers;
+    bool const ok = detail::parse_list_of_numbers(
+      boost::begin(attribute_value), boost::end(attribute_value), property_source, numbers);
+    coordinate_t const * const data = numbers.empty() ? NULL : &numbers[0];
+    args_t::value_events_policy::set(args_t::value_events_context::get(context), tag, property_source,
+      boost::iterator_range<coordinate_t const *>(data, data + numbers.size()));
+    if (!ok)
+#else
     namespace qi = boost::spirit::qi;
 
     typedef detail::value_parser_parameters<Context, SVGPP_TEMPLATE_ARGS_PASS> args_t;
@@ -73,6 +89,7 @@ struct value_parser<tag::type::list_of<tag::type::number>, SVGPP_TEMPLATE_ARGS_P
     args_t::value_events_policy::set(args_t::value_events_context::get(context), tag, property_source,
       boost::make_iterator_range(output_iterator_t(parse_list), output_iterator_t()));
     if (parse_list.error())
+#endif
     {
       return args_t::error_policy::parse_failed(args_t::error_policy_context::get(context), tag, attribute_value);
     }
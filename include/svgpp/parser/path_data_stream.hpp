@@ -0,0 +1,328 @@
+// Copyright Oleg Maximenko 2014.
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//
+// See http://github.com/svgpp/svgpp for library home page.
+
+#pragma once
+
+#include <boost/range.hpp>
+#include <boost/spirit/include/qi.hpp>
+#include <svgpp/definitions.hpp>
+#include <svgpp/number_type.hpp>
+#include <svgpp/parser/detail/common.hpp>
+#include <svgpp/policy/path_events.hpp>
+#include <string>
+
+namespace svgpp
+{
+
+// Parses path data passed by chunks. Events are emitted for each complete command (or implicitly
+// repeated command argument group) as soon as it is read, partially read number and command
+// state are kept between chunks. Accepts the same syntax and emits the same events as path_data_grammar.
+template <
+  class Context,
+  class Coordinate = typename number_type_by_context<Context>::type,
+  class EventsPolicy = policy::path_events::default_policy<Context>
+>
+class path_data_stream_parser
+{
+public:
+  explicit path_data_stream_parser(Context & context)
+    : context_(context)
+    , command_(0)
+    , absolute_(true)
+    , arg_count_(0)
+    , command_has_args_(false)
+    , comma_pending_(false)
+    , number_state_(number_none)
+    , failed_(false)
+  {}
+
+  // Returns false if path data is invalid. Events for the commands preceding the error are already emitted.
+  // Chunk may contain characters of any type, code units outside of ASCII range are invalid
+  template<class Range>
+  bool parse_chunk(Range const & chunk)
+  {
+    typedef typename boost::range_const_iterator<Range>::type iterator_t;
+    for(iterator_t it = boost::begin(chunk), end = boost::end(chunk); it != end && !failed_; ++it)
+    {
+      if (static_cast<unsigned long>(*it) > 0x7F)
+        failed_ = true;
+      else
+        put_char(static_cast<char>(*it));
+    }
+    return !failed_;
+  }
+
+  // Must be called after the last chunk. Emits path_exit event (as path_data_grammar does,
+  // path_exit is emitted also if path data is invalid)
+  bool finish()
+  {
+    if (!failed_)
+    {
+      if (number_state_ != number_none)
+        end_number();
+      if (!failed_ && (comma_pending_ || arg_count_ != 0 || (command_ != 0 && command_ != 'z' && !command_has_args_)))
+        failed_ = true;
+    }
+    EventsPolicy::path_exit(context_);
+    return !failed_;
+  }
+
+  bool failed() const { return failed_; }
+
+private:
+  Context & context_;
+  char command_; // Lower case command letter, 0 before the first command
+  bool absolute_;
+  Coordinate args_[7];
+  int arg_count_;
+  bool command_has_args_; // At least one argument group of the current command was read
+  bool comma_pending_;
+  std::string number_;
+  enum number_state
+  {
+    number_none,
+    number_sign,
+    number_integer,
+    number_dot_after_integer,
+    number_dot,
+    number_fraction,
+    number_exponent,
+    number_exponent_sign,
+    number_exponent_digits
+  } number_state_;
+  bool failed_;
+
+  struct nonnegative_real_policies : detail::svg_real_policies<Coordinate>
+  {
+    template<class Iterator>
+    inline static bool parse_sign(Iterator&, Iterator const&) { return false; }
+  };
+
+  static bool is_space(char c)
+  {
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\f' || c == '\v';
+  }
+
+  static bool is_digit(char c)
+  {
+    return c >= '0' && c <= '9';
+  }
+
+  int arity() const
+  {
+    switch (command_)
+    {
+    case 'h': case 'v':
+      return 1;
+    case 'm': case 'l': case 't':
+      return 2;
+    case 's': case 'q':
+      return 4;
+    case 'c':
+      return 6;
+    case 'a':
+      return 7;
+    default:
+      return 0;
+    }
+  }
+
+  void put_char(char c)
+  {
+    if (number_state_ != number_none)
+    {
+      if (continue_number(c))
+        return;
+      end_number();
+      if (failed_)
+        return;
+    }
+    if (is_space(c))
+      return;
+    if (c == ',')
+    {
+      // Comma is allowed only between arguments
+      if (comma_pending_ || arity() == 0 || (arg_count_ == 0 && !command_has_args_))
+        failed_ = true;
+      comma_pending_ = true;
+      return;
+    }
+    if (command_ == 'a' && (arg_count_ == 3 || arg_count_ == 4))
+    {
+      // Flags
+      if (c == '0' || c == '1')
+        add_argument(c == '1' ? 1 : 0);
+      else
+        failed_ = true;
+      return;
+    }
+    if (is_digit(c))
+      number_state_ = number_integer;
+    else if (c == '.')
+      number_state_ = number_dot;
+    else if (c == '+' || c == '-')
+      number_state_ = number_sign;
+    if (number_state_ != number_none)
+    {
+      if (arity() == 0)
+      {
+        number_state_ = number_none;
+        failed_ = true;
+        return;
+      }
+      number_.assign(1, c);
+      return;
+    }
+    start_command(c);
+  }
+
+  void start_command(char c)
+  {
+    char const command = (c >= 'A' && c <= 'Z') ? c - 'A' + 'a' : c;
+    if (std::string("mzlhvcsqta").find(command) == std::string::npos
+      || comma_pending_ || arg_count_ != 0
+      || (command_ == 0 && command != 'm')
+      || (command_ != 0 && command_ != 'z' && !command_has_args_))
+    {
+      failed_ = true;
+      return;
+    }
+    command_ = command;
+    absolute_ = command != c;
+    command_has_args_ = false;
+    if (command_ == 'z')
+      EventsPolicy::path_close_subpath(context_);
+  }
+
+  bool continue_number(char c)
+  {
+    bool const digit = is_digit(c);
+    switch (number_state_)
+    {
+    case number_sign:
+      if (digit)
+        number_state_ = number_integer;
+      else if (c == '.')
+        number_state_ = number_dot;
+      else
+        return false;
+      break;
+    case number_integer:
+      if (c == '.')
+        number_state_ = number_dot_after_integer;
+      else if (c == 'e' || c == 'E')
+        number_state_ = number_exponent;
+      else if (!digit)
+        return false;
+      break;
+    case number_dot_after_integer:
+    case number_dot:
+      if (digit)
+        number_state_ = number_fraction;
+      else
+        return false;
+      break;
+    case number_fraction:
+      if (c == 'e' || c == 'E')
+        number_state_ = number_exponent;
+      else if (!digit)
+        return false;
+      break;
+    case number_exponent:
+      if (digit)
+        number_state_ = number_exponent_digits;
+      else if (c == '+' || c == '-')
+        number_state_ = number_exponent_sign;
+      else
+        return false;
+      break;
+    case number_exponent_sign:
+    case number_exponent_digits:
+      if (digit)
+        number_state_ = number_exponent_digits;
+      else
+        return false;
+      break;
+    default:
+      return false;
+    }
+    number_ += c;
+    return true;
+  }
+
+  void end_number()
+  {
+    namespace qi = boost::spirit::qi;
+
+    number_state_ = number_none;
+    std::string::const_iterator it = number_.begin(), end = number_.end();
+    Coordinate value;
+    bool ok;
+    if (command_ == 'a' && arg_count_ < 2)
+      ok = qi::parse(it, end, qi::real_parser<Coordinate, nonnegative_real_policies>(), value);
+    else
+      ok = qi::parse(it, end, qi::real_parser<Coordinate, detail::svg_real_policies<Coordinate> >(), value);
+    if (ok && it == end)
+      add_argument(value);
+    else
+      failed_ = true;
+  }
+
+  void add_argument(Coordinate value)
+  {
+    comma_pending_ = false;
+    args_[arg_count_++] = value;
+    if (arg_count_ == arity())
+    {
+      arg_count_ = 0;
+      command_has_args_ = true;
+      if (absolute_)
+        call(tag::coordinate::absolute());
+      else
+        call(tag::coordinate::relative());
+    }
+  }
+
+  template<class AbsoluteOrRelative>
+  void call(AbsoluteOrRelative absolute_or_relative)
+  {
+    Coordinate const * a = args_;
+    switch (command_)
+    {
+    case 'm':
+      EventsPolicy::path_move_to(context_, a[0], a[1], absolute_or_relative);
+      // Subsequent pairs are implicit lineto commands
+      command_ = 'l';
+      break;
+    case 'l':
+      EventsPolicy::path_line_to(context_, a[0], a[1], absolute_or_relative);
+      break;
+    case 'h':
+    case 'v':
+      EventsPolicy::path_line_to_ortho(context_, a[0], command_ == 'h', absolute_or_relative);
+      break;
+    case 'c':
+      EventsPolicy::path_cubic_bezier_to(context_, a[0], a[1], a[2], a[3], a[4], a[5], absolute_or_relative);
+      break;
+    case 's':
+      EventsPolicy::path_cubic_bezier_to(context_, a[0], a[1], a[2], a[3], absolute_or_relative);
+      break;
+    case 'q':
+      EventsPolicy::path_quadratic_bezier_to(context_, a[0], a[1], a[2], a[3], absolute_or_relative);
+      break;
+    case 't':
+      EventsPolicy::path_quadratic_bezier_to(context_, a[0], a[1], absolute_or_relative);
+      break;
+    case 'a':
+      EventsPolicy::path_elliptical_arc_to(context_, a[0], a[1], a[2],
+        a[3] != 0, a[4] != 0, a[5], a[6], absolute_or_relative);
+      break;
+    }
+  }
+};
+
+}
@@ -14,6 +14,7 @@
 #include <svgpp/policy/icc_color.hpp>
 #include <svgpp/policy/iri.hpp>
 #include <svgpp/policy/length.hpp>
+#include <svgpp/policy/list_of_points.hpp>
 #include <svgpp/policy/basic_shapes_events.hpp>
 #include <svgpp/policy/path_events.hpp>
 #include <svgpp/policy/transform_events.hpp>
@@ -73,6 +74,12 @@ struct get_default_policy<Context, tag::iri_policy>
   typedef typename policy::iri::by_context<Context>::type type;
 };
 
+template<class Context>
+struct get_default_policy<Context, tag::list_of_points_policy>
+{
+  typedef typename policy::list_of_points::by_context<Context>::type type;
+};
+
 template<class Context>
 struct get_default_policy<Context, tag::markers_policy>
 {
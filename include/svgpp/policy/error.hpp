@@ -7,9 +7,12 @@
 
 #pragma once
 
+#include <boost/circular_buffer.hpp>
 #include <boost/exception/all.hpp>
 #include <boost/format.hpp>
+#include <boost/optional.hpp>
 #include <boost/range/iterator.hpp>
+#include <boost/type_traits/is_convertible.hpp>
 #include <svgpp/definitions.hpp>
 #include <svgpp/detail/attribute_name.hpp>
 #include <svgpp/detail/namespace.hpp>
@@ -231,6 +234,163 @@ private:
   BOOST_DELETED_FUNCTION(invalid_value_error& operator= (invalid_value_error const&))
 };
 
+BOOST_SCOPED_ENUM_START(error_code)
+{
+  unknown_element,
+  unexpected_element,
+  unknown_attribute,
+  unknown_css_property,
+  unexpected_attribute,
+  required_attribute_not_found,
+  invalid_value,
+  negative_value
+};
+BOOST_SCOPED_ENUM_END
+
+// Error record stored by policy::error::collect. Message text is made only on request
+template<class XMLElement>
+struct diagnostic
+{
+  diagnostic(BOOST_SCOPED_ENUM(error_code) code, detail::attribute_id attribute_id)
+    : code(code)
+    , attribute_id(attribute_id)
+  {}
+
+  BOOST_SCOPED_ENUM(error_code) code;
+  detail::attribute_id attribute_id; // unknown_attribute_id if attribute isn't known or not applicable
+  std::string name; // Name of unknown element, attribute or CSS property, if available as char range
+  // Element with error or, for attribute errors, element being processed. Not set if traversal
+  // isn't done by document_traversal
+  boost::optional<XMLElement> element; 
+
+  std::string message() const
+  {
+    std::string attribute;
+    if (attribute_id != detail::unknown_attribute_id)
+      attribute = std::string(" \"") + attribute_name<char>::by_id(attribute_id) + "\"";
+    std::string const quoted_name = name.empty() ? name : " \"" + name + "\"";
+    switch (code)
+    {
+    case error_code::unknown_element:              return "Unknown SVG element" + quoted_name;
+    case error_code::unexpected_element:           return "Unexpected SVG element";
+    case error_code::unknown_attribute:            return "Unknown attribute" + quoted_name;
+    case error_code::unknown_css_property:         return "Unknown CSS property" + quoted_name;
+    case error_code::unexpected_attribute:         return "Unexpected attribute" + attribute;
+    case error_code::required_attribute_not_found: return "Required SVG attribute" + attribute + " not found";
+    case error_code::invalid_value:                return "Invalid value of SVG attribute (or property)" + attribute;
+    case error_code::negative_value:               return "Negative value of attribute" + attribute;
+    }
+    return std::string();
+  }
+};
+
+// Fixed size ring buffer of diagnostics. When it is full, the oldest records are overwritten
+template<class XMLElement>
+class diagnostics_log
+{
+public:
+  typedef diagnostic<XMLElement> value_type;
+  typedef boost::circular_buffer<value_type> container_type;
+
+  explicit diagnostics_log(size_t capacity = 256)
+    : entries_(capacity)
+    , overwritten_(0)
+  {}
+
+  void add(value_type const & value)
+  {
+    if (entries_.full())
+      ++overwritten_;
+    entries_.push_back(value);
+  }
+
+  void add_attribute_error(BOOST_SCOPED_ENUM(error_code) code, detail::attribute_id id)
+  {
+    value_type value(code, id);
+    value.element = current_element_;
+    add(value);
+  }
+
+  template<class Name>
+  void add_attribute_error(BOOST_SCOPED_ENUM(error_code) code, detail::attribute_id id, Name const & name)
+  {
+    value_type value(code, id);
+    assign_name(value.name, name);
+    value.element = current_element_;
+    add(value);
+  }
+
+  template<class Element>
+  void add_element_error(BOOST_SCOPED_ENUM(error_code) code, Element const & element)
+  {
+    value_type value(code, detail::unknown_attribute_id);
+    assign_element(value.element, element);
+    add(value);
+  }
+
+  template<class Element, class Name>
+  void add_element_error(BOOST_SCOPED_ENUM(error_code) code, Element const & element, Name const & name)
+  {
+    value_type value(code, detail::unknown_attribute_id);
+    assign_name(value.name, name);
+    assign_element(value.element, element);
+    add(value);
+  }
+
+  // Called by document_traversal around processing of element attributes, so that
+  // attribute errors are attributed to the element
+  template<class Element>
+  void set_current_element(Element const & element)
+  {
+    assign_element(current_element_, element);
+  }
+
+  void reset_current_element()
+  {
+    current_element_ = boost::none;
+  }
+
+  container_type const & entries() const { return entries_; }
+  size_t overwritten() const { return overwritten_; }
+  bool empty() const { return entries_.empty(); }
+
+  void clear()
+  {
+    entries_.clear();
+    overwritten_ = 0;
+    current_element_ = boost::none;
+  }
+
+private:
+  container_type entries_;
+  size_t overwritten_;
+  boost::optional<XMLElement> current_element_;
+
+  template<class Element>
+  static void assign_element(boost::optional<XMLElement> & dst, Element const & element,
+    typename boost::enable_if<boost::is_convertible<Element, XMLElement> >::type * = NULL)
+  {
+    dst = element;
+  }
+
+  template<class Element>
+  static void assign_element(boost::optional<XMLElement> &, Element const &,
+    typename boost::disable_if<boost::is_convertible<Element, XMLElement> >::type * = NULL)
+  {}
+
+  template<class Name>
+  static void assign_name(std::string & dst, Name const & name,
+    typename boost::enable_if<typename detail::is_char_range<Name>::type>::type * = NULL)
+  {
+    dst.assign(boost::begin(name), boost::end(name));
+  }
+
+  template<class Name>
+  static void assign_name(std::string &, Name const &,
+    typename boost::disable_if<typename detail::is_char_range<Name>::type>::type * = NULL)
+  {}
+};
+
 namespace policy { namespace error 
 {
 
@@ -359,6 +519,103 @@ struct raise_exception
   }
 };
 
+// Doesn't throw, errors are stored to the log returned by context.diagnostics() and processing
+// continues with the next attribute or element. Context must have method
+//   diagnostics_log<XMLElement> & diagnostics() const;
+// Byte offsets of errors aren't recorded, as XML policies don't provide them.
+template<class Context>
+struct collect
+{
+  typedef Context context_type;
+
+  template<class XMLElement, class ElementName>
+  static bool unknown_element(Context const & context, 
+    XMLElement const & element, ElementName const & name)
+  {
+    context.diagnostics().add_element_error(error_code::unknown_element, element, name);
+    return true;
+  }
+
+  template<class XMLAttribute, class AttributeName>
+  static bool unknown_attribute(Context const & context, 
+    XMLAttribute const &, 
+    AttributeName const & name,
+    BOOST_SCOPED_ENUM(detail::namespace_id) namespace_id,
+    tag::source::attribute)
+  {
+    if (namespace_id == detail::namespace_id::svg)
+      context.diagnostics().add_attribute_error(error_code::unknown_attribute, detail::unknown_attribute_id, name);
+    return true;
+  }
+
+  template<class XMLAttribute, class AttributeName>
+  static bool unknown_attribute(Context const & context, 
+    XMLAttribute const &, 
+    AttributeName const & name,
+    tag::source::css)
+  {
+    context.diagnostics().add_attribute_error(error_code::unknown_css_property, detail::unknown_attribute_id, name);
+    return true;
+  }
+
+  static bool unexpected_attribute(Context const & context, 
+    detail::attribute_id id, tag::source::attribute)
+  {
+    add(context, error_code::unexpected_attribute, id);
+    return true;
+  }
+  
+  template<class AttributeTag>
+  static bool required_attribute_not_found(Context const & context, AttributeTag)
+  {
+    add(context, error_code::required_attribute_not_found, AttributeTag::attribute_id);
+    return true;
+  }
+
+  template<class AttributeTag, class AttributeValue>
+  static bool parse_failed(Context const & context, AttributeTag,
+    AttributeValue const &)
+  {
+    add(context, error_code::invalid_value, AttributeTag::attribute_id);
+    return true;
+  }
+
+  template<class XMLElement>
+  static bool unexpected_element(Context const & context, 
+    XMLElement const & element)
+  {
+    context.diagnostics().add_element_error(error_code::unexpected_element, element);
+    return true;
+  }
+
+  template<class AttributeTag>
+  static bool negative_value(Context const & context, AttributeTag)
+  {
+    add(context, error_code::negative_value, AttributeTag::attribute_id);
+    return true;
+  }
+
+  // Makes document_traversal call on_enter_attributes/on_exit_attributes
+  typedef boost::true_type tracks_current_element;
+
+  template<class XMLElement>
+  static void on_enter_attributes(Context const & context, XMLElement const & element)
+  {
+    context.diagnostics().set_current_element(element);
+  }
+
+  static void on_exit_attributes(Context const & context)
+  {
+    context.diagnostics().reset_current_element();
+  }
+
+private:
+  static void add(Context const & context, BOOST_SCOPED_ENUM(error_code) code, detail::attribute_id id)
+  {
+    context.diagnostics().add_attribute_error(code, id);
+  }
+};
+
 template<class Context>
 struct default_policy: raise_exception<Context>
 {};
@@ -0,0 +1,34 @@
+// Copyright Oleg Maximenko 2014.
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//
+// See http://github.com/svgpp/svgpp for library home page.
+
+#pragma once
+
+namespace svgpp { namespace policy { namespace list_of_points
+{
+
+// Points are parsed lazily while user code iterates the range of std::pair<number_type, number_type>
+struct pairs_range
+{
+  static const bool coordinate_array = false;
+};
+
+// Whole attribute is parsed at once, points are passed as single boost::iterator_range<number_type const *>
+// of contiguous x0, y0, x1, y1, ... coordinates
+struct flat_coordinates
+{
+  static const bool coordinate_array = true;
+};
+
+typedef pairs_range default_policy;
+
+template<class Context>
+struct by_context
+{
+  typedef default_policy type;
+};
+
+}}}
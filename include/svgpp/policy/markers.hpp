@@ -47,6 +47,54 @@ struct radians
   }
 };
 
+// Avoids trigonometric functions: direction is passed as normalized vector, 
+// that is also cosine and sine of the marker rotation angle
+template<class Number = double>
+struct unit_vector
+{
+  struct direction
+  {
+    Number cos, sin;
+  };
+
+  typedef direction directionality_type;
+
+  static directionality_type undetermined_directionality() // "align with the positive x-axis in user space"
+  {
+    directionality_type dir = { 1, 0 };
+    return dir;
+  }
+
+  template<class Coordinate>
+  static directionality_type segment_directionality(Coordinate dx, Coordinate dy)
+  {
+    Number const length = std::sqrt(Number(dx) * dx + Number(dy) * dy);
+    directionality_type dir = { dx / length, dy / length };
+    return dir;
+  }
+
+  static directionality_type bisector_directionality(directionality_type const & in_segment, directionality_type const & out_segment)
+  {
+    Number const x = in_segment.cos + out_segment.cos;
+    Number const y = in_segment.sin + out_segment.sin;
+    Number const length = std::sqrt(x * x + y * y);
+    if (length == 0)
+    {
+      // Opposite directions - turning by right angle. Like in radians policy, result is the 
+      // mean of angles in (-pi, pi], so it doesn't depend on the order of segments
+      if (in_segment.sin > 0 || (in_segment.sin == 0 && in_segment.cos < 0))
+      {
+        directionality_type dir = { in_segment.sin, -in_segment.cos };
+        return dir;
+      }
+      directionality_type dir = { -in_segment.sin, in_segment.cos };
+      return dir;
+    }
+    directionality_type dir = { x / length, y / length };
+    return dir;
+  }
+};
+
 } // namespace marker_directionality
 
 namespace markers
@@ -68,6 +116,18 @@ struct calculate_always
   static const bool always_calculate_auto_orient = true; // Doesn't call marker_get_config if true
 };
 
+template<class DirectionalityPolicy>
+struct calculate_using: calculate
+{
+  typedef DirectionalityPolicy directionality_policy;
+};
+
+template<class DirectionalityPolicy>
+struct calculate_always_using: calculate_always
+{
+  typedef DirectionalityPolicy directionality_policy;
+};
+
 struct raw
 {
   static const bool calculate_markers = false;
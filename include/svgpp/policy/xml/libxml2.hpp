@@ -26,85 +26,112 @@ namespace detail
   public:
     libxml_string_ptr()
       : str_(NULL)
+      , owned_(false)
     {}
 
     explicit libxml_string_ptr(xmlChar * str)
       : str_(str)
+      , owned_(true)
     {}
 
+    // Refers to string owned by libxml2 tree, that will not be freed
+    static libxml_string_ptr borrow(xmlChar const * str)
+    {
+      libxml_string_ptr result;
+      result.str_ = const_cast<xmlChar *>(str);
+      return result;
+    }
+
 #ifndef BOOST_NO_CXX11_RVALUE_REFERENCES
     libxml_string_ptr(libxml_string_ptr && src)
       : str_(src.str_)
+      , owned_(src.owned_)
     {
       src.str_ = NULL;
+      src.owned_ = false;
     }
 #else
     libxml_string_ptr(libxml_string_ptr & src)
       : str_(src.str_)
+      , owned_(src.owned_)
     {
       src.str_ = NULL;
+      src.owned_ = false;
     }
 
     struct ref
     {
       xmlChar * ptr_;
+      bool owned_;
 
-      explicit ref(xmlChar * ptr): ptr_(ptr) { }
+      ref(xmlChar * ptr, bool owned): ptr_(ptr), owned_(owned) { }
     };
 
     libxml_string_ptr(ref __ref) throw()
       : str_(__ref.ptr_)
+      , owned_(__ref.owned_)
     {}
 
     operator ref() throw()
     {
-      xmlChar * str = str_;
+      ref r(str_, owned_);
       str_ = NULL;
-      return ref(str);
+      owned_ = false;
+      return r;
     }
 #endif
 
     ~libxml_string_ptr()
     {
-      if (str_)
-        xmlFree(str_);
+      free();
     }
 
 #ifndef BOOST_NO_CXX11_RVALUE_REFERENCES
     libxml_string_ptr & operator=(libxml_string_ptr && src)
     {
-      if (str_)
-        xmlFree(str_);
+      free();
       str_ = src.str_;
+      owned_ = src.owned_;
       src.str_ = NULL;
+      src.owned_ = false;
       return *this;
     }
 #else
     libxml_string_ptr & operator=(libxml_string_ptr & src)
     {
-      if (str_)
-        xmlFree(str_);
+      free();
       str_ = src.str_;
+      owned_ = src.owned_;
       src.str_ = NULL;
+      src.owned_ = false;
       return *this;
     }
 
     libxml_string_ptr & operator=(ref r)
     {
-      if (str_)
-        xmlFree(str_);
+      free();
       str_ = r.ptr_;
+      owned_ = r.owned_;
       return *this;
     }
 #endif
 
     boost::iterator_range<const char *> get_range() const
     {
+      if (!str_)
+        return boost::iterator_range<const char *>();
       return boost::as_literal(reinterpret_cast<const char *>(str_));
     }
 
   private:
     xmlChar * str_;
+    bool owned_;
+
+    void free()
+    {
+      if (str_ && owned_)
+        xmlFree(str_);
+    }
   };
 }
   
@@ -163,7 +190,14 @@ struct attribute_iterator<xmlAttr *>
 
   static attribute_value_type get_value(iterator_type xml_attribute)
   {
-    return detail::libxml_string_ptr(
+    // Attribute value that consists of single text node (no entity references) is 
+    // passed as is, without copying
+    xmlNode const * value_node = xml_attribute->children;
+    if (value_node == NULL)
+      return attribute_value_type();
+    if (value_node->next == NULL && value_node->type == XML_TEXT_NODE)
+      return attribute_value_type::borrow(value_node->content);
+    return attribute_value_type(
       xmlNodeListGetString(xml_attribute->doc, xml_attribute->children, 1));
   }
 
@@ -226,8 +260,10 @@ struct element_iterator<xmlNode *>
 
   static element_text_type get_text(iterator_type xml_element)
   {
-    return detail::libxml_string_ptr(
-      xmlNodeListGetString(xml_element->doc, xml_element, 1)).get_range();
+    // Only text and CDATA nodes are passed here, their content is used in place
+    if (xml_element->content == NULL)
+      return element_text_type();
+    return boost::as_literal(reinterpret_cast<const char *>(xml_element->content));
   }
 
   static attribute_enumerator_type get_attributes(iterator_type xml_element)
@@ -45,6 +45,13 @@ struct attribute_iterator<rapidxml_ns::xml_attribute<Ch> const *>
   {
     if (xml_attribute->namespace_uri_size() == 0)
       return detail::namespace_id::svg;
+    if (xml_attribute->namespace_uri() == rapidxml_ns::xml_namespace<Ch>::uri())
+      return detail::namespace_id::xml;
+#if defined(RAPIDXML_NS_INTERNED_NAMESPACE_URIS)
+    if (xml_attribute->namespace_uri() == rapidxml_ns::xlink_namespace<Ch>::uri())
+      return detail::namespace_id::xlink;
+#endif
+    // URI wasn't interned by the parser (e.g. custom namespace processor was used)
     boost::iterator_range<Ch const *> ns_uri(xml_attribute->namespace_uri(), 
       xml_attribute->namespace_uri() + xml_attribute->namespace_uri_size());
     if (boost::range::equal(detail::xml_namespace_uri<Ch>(), ns_uri))
@@ -155,13 +162,16 @@ private:
   template<bool TextsAlso>
   static void find_next(iterator_type & xml_element)
   {
-    // TODO: optimize namespace checking by saving pointer to last namespace_uri() known to be SVG
     for(; xml_element; xml_element = xml_element->next_sibling())
     {
       switch(xml_element->type())
       {
       case rapidxml_ns::node_element:
       {
+#if defined(RAPIDXML_NS_INTERNED_NAMESPACE_URIS)
+        if (xml_element->namespace_uri() == rapidxml_ns::svg_namespace<Ch>::uri())
+          return;
+#endif
         boost::iterator_range<Ch const *> ns_uri(xml_element->namespace_uri(), 
           xml_element->namespace_uri() + xml_element->namespace_uri_size());
         if (boost::range::equal(detail::svg_namespace_uri<Ch>(), ns_uri))
@@ -70,6 +70,7 @@ BOOST_PARAMETER_TEMPLATE_KEYWORD(transform_events_policy)
 BOOST_PARAMETER_TEMPLATE_KEYWORD(value_events_policy)
 BOOST_PARAMETER_TEMPLATE_KEYWORD(viewport_events_policy)
 BOOST_PARAMETER_TEMPLATE_KEYWORD(length_policy)
+BOOST_PARAMETER_TEMPLATE_KEYWORD(list_of_points_policy)
 BOOST_PARAMETER_TEMPLATE_KEYWORD(markers_policy)
 BOOST_PARAMETER_TEMPLATE_KEYWORD(number_type)
 BOOST_PARAMETER_TEMPLATE_KEYWORD(path_policy)
@@ -24,8 +24,8 @@ void arc_endpoint_to_center(Number x1, Number y1, Number x2, Number y2,
   Number x1s, y1s;
   {
     // SVG 1.1 (F.6.5.1)
-    Number dx2 = (x1 - x2) * 0.5;
-    Number dy2 = (y1 - y2) * 0.5;
+    Number dx2 = (x1 - x2) / 2;
+    Number dy2 = (y1 - y2) / 2;
 
     x1s =  cos_phi * dx2 + sin_phi * dy2;
     y1s = -sin_phi * dx2 + cos_phi * dy2;
@@ -57,8 +57,8 @@ void arc_endpoint_to_center(Number x1, Number y1, Number x2, Number y2,
     cys = -coeff * x1s / rx_ry;
   }
   // SVG 1.1 (F.6.5.3)
-  cx = cxs * cos_phi - cys * sin_phi + (x1 + x2) * 0.5;
-  cy = cxs * sin_phi + cys * cos_phi + (y1 + y2) * 0.5;
+  cx = cxs * cos_phi - cys * sin_phi + (x1 + x2) / 2;
+  cy = cxs * sin_phi + cys * cos_phi + (y1 + y2) / 2;
   theta1 = std::atan2(( y1s - cys)/ry, ( x1s - cxs)/rx);
   theta2 = std::atan2((-y1s - cys)/ry, (-x1s - cxs)/rx);
 }
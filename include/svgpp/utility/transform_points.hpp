@@ -0,0 +1,44 @@
+// Copyright Oleg Maximenko 2014.
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//
+// See http://github.com/svgpp/svgpp for library home page.
+
+#pragma once
+
+#include <cstddef>
+#include <boost/array.hpp>
+
+namespace svgpp
+{
+
+// Applies affine transformation matrix (in the order used by transform events: a b c d e f)
+// to the points, whose coordinates are stored in separate arrays.
+// Iterations are independent, so the loop is vectorized by optimizing compiler. Output arrays may be
+// the same as input ones.
+template<class Number>
+void transform_points(boost::array<Number, 6> const & matrix,
+  Number const * x, Number const * y,
+  Number * x_out, Number * y_out,
+  std::size_t count)
+{
+  Number const a = matrix[0], b = matrix[1], c = matrix[2], d = matrix[3], e = matrix[4], f = matrix[5];
+  for(std::size_t i = 0; i < count; ++i)
+  {
+    Number const px = x[i];
+    Number const py = y[i];
+    x_out[i] = a * px + c * py + e;
+    y_out[i] = b * px + d * py + f;
+  }
+}
+
+// In place transformation of coordinates stored in separate arrays
+template<class Number>
+void transform_points(boost::array<Number, 6> const & matrix,
+  Number * x, Number * y, std::size_t count)
+{
+  transform_points(matrix, static_cast<Number const *>(x), static_cast<Number const *>(y), x, y, count);
+}
+
+}
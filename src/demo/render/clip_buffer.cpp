@@ -22,11 +22,13 @@ typedef agg::renderer_base<pixfmt_t> renderer_base_t;
 ClipBuffer::ClipBuffer(int width, int height)
   : buffer_(width * height, 0xff)
   , width_(width), height_(height)
+  , bounds_(0, 0, width, height)
 {}
 
 ClipBuffer::ClipBuffer(ClipBuffer const & src)
   : buffer_(src.buffer_)
   , width_(src.width_), height_(src.height_)
+  , bounds_(src.bounds_)
 {}
 
 boost::gil::gray8c_view_t ClipBuffer::gilView() const
@@ -54,19 +56,30 @@ void ClipBuffer::intersectClipRect(transform_t const & transform, number_t x, nu
   rasterizer.line_to_d(0, pixfmt.height());
   rasterizer.close_polygon();
 
-  number_t px = x, py = y;
-  transform.transform(&px, &py);
-  rasterizer.move_to_d(px, py);
-  px = x + width; py = y;
-  transform.transform(&px, &py);
-  rasterizer.line_to_d(px, py);
-  px = x + width; py = y + height;
-  transform.transform(&px, &py);
-  rasterizer.line_to_d(px, py);
-  px = x; py = y + height;
-  transform.transform(&px, &py);
-  rasterizer.line_to_d(px, py);
+  number_t const corners_x[] = { x, x + width, x + width, x };
+  number_t const corners_y[] = { y, y, y + height, y + height };
+  number_t min_x = 0, min_y = 0, max_x = 0, max_y = 0;
+  for(int i = 0; i < 4; ++i)
+  {
+    number_t px = corners_x[i], py = corners_y[i];
+    transform.transform(&px, &py);
+    if (i == 0)
+    {
+      rasterizer.move_to_d(px, py);
+      min_x = max_x = px;
+      min_y = max_y = py;
+    }
+    else
+    {
+      rasterizer.line_to_d(px, py);
+      min_x = std::min(min_x, px);
+      min_y = std::min(min_y, py);
+      max_x = std::max(max_x, px);
+      max_y = std::max(max_y, py);
+    }
+  }
   rasterizer.close_polygon();
+  bounds_ = bounds_.intersect(PixelRect::bounding(min_x, min_y, max_x, max_y));
 
   agg::render_scanlines_aa_solid(rasterizer, scanline, renderer_base, agg::gray8(0));
 #elif defined(RENDERER_GDIPLUS)
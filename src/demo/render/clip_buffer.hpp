@@ -11,6 +11,8 @@ public:
   ClipBuffer(ClipBuffer const & src);
 
   boost::gil::gray8c_view_t gilView() const;
+  // Conservative bounds of the area that is not clipped out
+  PixelRect const & bounds() const { return bounds_; }
 
   void intersectClipRect(transform_t const & transform, number_t x, number_t y, number_t width, number_t height);
   void intersectClipPath(XMLDocument & xml_document, svg_string_t const & id, transform_t const & transform);
@@ -18,4 +20,5 @@ public:
 private:
   std::vector<unsigned char> buffer_;
   const int width_, height_;
+  PixelRect bounds_;
 };
\ No newline at end of file
@@ -40,6 +40,8 @@
 #endif
 #include <boost/function.hpp>
 #include <boost/tuple/tuple.hpp>
+#include <algorithm>
+#include <cmath>
 #include <map>
 
 #if defined(RENDERER_AGG)
@@ -106,6 +108,57 @@ typedef svgpp::factory::length::unitless<number_t, number_t> length_factory_t;
 typedef boost::tuple<double, double, double, double> bounding_box_t;
 typedef boost::function<bounding_box_t()> get_bounding_box_func_t;
 
+// Pixels [x1, x2) x [y1, y2) in canvas coordinates
+struct PixelRect
+{
+  PixelRect()
+    : x1(0), y1(0), x2(0), y2(0)
+  {}
+
+  PixelRect(int x1, int y1, int x2, int y2)
+    : x1(x1), y1(y1), x2(x2), y2(y2)
+  {}
+
+  // Smallest rectangle containing all pixels touched by the antialiased area
+  static PixelRect bounding(number_t min_x, number_t min_y, number_t max_x, number_t max_y)
+  {
+    return PixelRect(
+      int(std::floor(min_x)) - 1, int(std::floor(min_y)) - 1, 
+      int(std::ceil(max_x)) + 1, int(std::ceil(max_y)) + 1);
+  }
+
+  int width() const { return x2 - x1; }
+  int height() const { return y2 - y1; }
+  bool empty() const { return x1 >= x2 || y1 >= y2; }
+
+  bool contains(PixelRect const & r) const
+  {
+    return r.empty() || (x1 <= r.x1 && y1 <= r.y1 && r.x2 <= x2 && r.y2 <= y2);
+  }
+
+  PixelRect intersect(PixelRect const & r) const
+  {
+    PixelRect result(std::max(x1, r.x1), std::max(y1, r.y1), std::min(x2, r.x2), std::min(y2, r.y2));
+    return result.empty() ? PixelRect() : result;
+  }
+
+  PixelRect unite(PixelRect const & r) const
+  {
+    if (empty())
+      return r;
+    if (r.empty())
+      return *this;
+    return PixelRect(std::min(x1, r.x1), std::min(y1, r.y1), std::max(x2, r.x2), std::max(y2, r.y2));
+  }
+
+  bool operator==(PixelRect const & r) const
+  {
+    return x1 == r.x1 && y1 == r.y1 && x2 == r.x2 && y2 == r.y2;
+  }
+
+  int x1, y1, x2, y2;
+};
+
 #if defined(RENDERER_GDIPLUS)
 inline void AssignMatrix(Gdiplus::Matrix & dest, Gdiplus::Matrix const & src)
 {
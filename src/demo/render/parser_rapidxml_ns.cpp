@@ -1,6 +1,10 @@
 #include "parser_rapidxml_ns.hpp"
-#include <rapidxml_ns/rapidxml_ns_utils.hpp>
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+#include <fstream>
 #include <map>
+#include <stdexcept>
+#include <vector>
 
 namespace
 {
@@ -21,12 +25,84 @@ namespace
 class XMLDocument::Impl
 {
 public:
-  Impl(const char * fileName)
-    : xml_file_(fileName)
+  void load(const char * fileName, bool useFileMapping)
   {
-    doc_.parse<rapidxml_ns::parse_no_string_terminators>(xml_file_.data());  
+    reset();
+    char * text = NULL;
+    if (useFileMapping)
+      text = mapFile(fileName);
+    if (!text)
+      text = readFile(fileName);
+    parse(text);
   }
 
+  void loadInSitu(char * text)
+  {
+    reset();
+    parse(text);
+  }
+
+private:
+  void parse(char * text)
+  {
+    try
+    {
+      doc_.parse<rapidxml_ns::parse_no_string_terminators | rapidxml_ns::parse_simd>(text);  
+    }
+    catch (...)
+    {
+      reset();
+      throw;
+    }
+  }
+
+  // Releases previous document, keeping memory pool and file buffer capacity for the next one
+  void reset()
+  {
+    element_by_id_.clear();
+    doc_.reset();
+    boost::interprocess::mapped_region().swap(mapped_region_);
+    boost::interprocess::file_mapping().swap(file_mapping_);
+  }
+
+  // Reads file to file_buffer_ and adds terminating zero, like rapidxml_ns::file does
+  char * readFile(const char * fileName)
+  {
+    std::ifstream stream(fileName, std::ios::binary);
+    if (!stream)
+      throw std::runtime_error(std::string("cannot open file ") + fileName);
+    stream.seekg(0, std::ios::end);
+    size_t size = static_cast<size_t>(stream.tellg());
+    stream.seekg(0);   
+    file_buffer_.resize(size + 1);
+    stream.read(&file_buffer_[0], static_cast<std::streamsize>(size));
+    file_buffer_[size] = 0;
+    return &file_buffer_[0];
+  }
+
+  // Returns NULL if file can't be mapped with zero byte following its content
+  char * mapFile(const char * fileName)
+  {
+    namespace bip = boost::interprocess;
+    try
+    {
+      bip::file_mapping mapping(fileName, bip::read_only);
+      bip::mapped_region region(mapping, bip::copy_on_write);
+      // Rest of the last page is zero-filled, so there is the terminating zero
+      // only if file size isn't multiple of page size
+      if (region.get_size() == 0 || region.get_size() % bip::mapped_region::get_page_size() == 0)
+        return NULL;
+      file_mapping_.swap(mapping);
+      mapped_region_.swap(region);
+      return static_cast<char *>(mapped_region_.get_address());
+    }
+    catch (bip::interprocess_exception const &)
+    {
+      return NULL;
+    }
+  }
+
+public:
   XMLElement getRoot()
   {
     return doc_.first_node();
@@ -41,7 +117,9 @@ public:
   }
 
 private:
-  rapidxml_ns::file<> xml_file_;
+  std::vector<char> file_buffer_;
+  boost::interprocess::file_mapping file_mapping_;
+  boost::interprocess::mapped_region mapped_region_;
   rapidxml_ns::xml_document<> doc_;
   typedef std::map<svg_string_t, XMLElement> element_by_id_t;
   element_by_id_t element_by_id_;
@@ -53,9 +131,18 @@ XMLDocument::XMLDocument()
 XMLDocument::~XMLDocument()
 {}
 
-void XMLDocument::load(const char * fileName)
+void XMLDocument::load(const char * fileName, bool useFileMapping)
+{
+  if (!impl_.get())
+    impl_.reset(new Impl);
+  impl_->load(fileName, useFileMapping);
+}
+
+void XMLDocument::loadInSitu(char * text)
 {
-  impl_.reset(new Impl(fileName));
+  if (!impl_.get())
+    impl_.reset(new Impl);
+  impl_->loadInSitu(text);
 }
 
 XMLElement XMLDocument::getRoot()
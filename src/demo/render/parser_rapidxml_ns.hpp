@@ -14,7 +14,14 @@ public:
   XMLDocument();
   ~XMLDocument();
 
-  void load(const char * fileName);
+  // Each load releases previous document, but keeps its memory for reuse. Loading many documents
+  // with the same XMLDocument instance (e.g. one per thread) doesn't allocate memory for nodes
+  // once the pool has grown to the largest document size.
+  // File is mapped to memory copy-on-write and parsed in place, unless useFileMapping is false
+  // or the file size doesn't leave room for the terminating zero in the last page
+  void load(const char * fileName, bool useFileMapping = true);
+  // Parses zero-terminated text in place. Text is modified and must outlive the document
+  void loadInSitu(char * text);
   XMLElement getRoot();
 
   XMLElement findElementById(svg_string_t const & id);
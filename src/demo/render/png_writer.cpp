@@ -0,0 +1,513 @@
+#include "png_writer.hpp"
+
+#include <boost/cstdint.hpp>
+#include <boost/noncopyable.hpp>
+#include <algorithm>
+#include <condition_variable>
+#include <cstdlib>
+#include <fstream>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace
+{
+  unsigned long const AdlerBase = 65521;
+
+  unsigned long adler32(unsigned long adler, unsigned char const * data, size_t size)
+  {
+    unsigned long s1 = adler & 0xffff, s2 = adler >> 16;
+    while (size > 0)
+    {
+      // 5552 is the largest block that can't overflow s2
+      size_t const block = std::min<size_t>(size, 5552);
+      for(size_t i = 0; i < block; ++i)
+      {
+        s1 += data[i];
+        s2 += s1;
+      }
+      s1 %= AdlerBase;
+      s2 %= AdlerBase;
+      data += block;
+      size -= block;
+    }
+    return (s2 << 16) | s1;
+  }
+
+  // Adler-32 of concatenation of two sequences (same as adler32_combine in zlib)
+  unsigned long adler32Combine(unsigned long adler1, unsigned long adler2, size_t size2)
+  {
+    unsigned long const rem = static_cast<unsigned long>(size2 % AdlerBase);
+    unsigned long sum1 = adler1 & 0xffff;
+    unsigned long sum2 = (rem * sum1) % AdlerBase;
+    sum1 += (adler2 & 0xffff) + AdlerBase - 1;
+    sum2 += (adler1 >> 16) + (adler2 >> 16) + AdlerBase - rem;
+    if (sum1 >= AdlerBase) sum1 -= AdlerBase;
+    if (sum1 >= AdlerBase) sum1 -= AdlerBase;
+    if (sum2 >= (AdlerBase << 1)) sum2 -= (AdlerBase << 1);
+    if (sum2 >= AdlerBase) sum2 -= AdlerBase;
+    return sum1 | (sum2 << 16);
+  }
+
+  class Crc32
+  {
+  public:
+    Crc32()
+      : crc_(0xffffffffu)
+    {}
+
+    void update(unsigned char const * data, size_t size)
+    {
+      static const Table table;
+      for(size_t i = 0; i < size; ++i)
+        crc_ = table.values_[(crc_ ^ data[i]) & 0xff] ^ (crc_ >> 8);
+    }
+
+    boost::uint32_t value() const { return ~crc_; }
+
+  private:
+    struct Table
+    {
+      Table()
+      {
+        for(boost::uint32_t n = 0; n < 256; ++n)
+        {
+          boost::uint32_t c = n;
+          for(int k = 0; k < 8; ++k)
+            c = c & 1 ? 0xedb88320u ^ (c >> 1) : c >> 1;
+          values_[n] = c;
+        }
+      }
+
+      boost::uint32_t values_[256];
+    };
+
+    boost::uint32_t crc_;
+  };
+
+  // Deflate stream writer. Bits are packed starting from the least significant bit
+  class BitWriter
+  {
+  public:
+    explicit BitWriter(std::vector<unsigned char> & out)
+      : out_(out), bits_(0), count_(0)
+    {}
+
+    void add(unsigned value, int count)
+    {
+      bits_ |= value << count_;
+      count_ += count;
+      for(; count_ >= 8; count_ -= 8, bits_ >>= 8)
+        out_.push_back(static_cast<unsigned char>(bits_));
+    }
+
+    // Huffman codes are packed starting from the most significant bit
+    void addHuffman(unsigned code, int count)
+    {
+      unsigned reversed = 0;
+      for(int i = 0; i < count; ++i, code >>= 1)
+        reversed = (reversed << 1) | (code & 1);
+      add(reversed, count);
+    }
+
+    void alignToByte()
+    {
+      if (count_ > 0)
+        add(0, 8 - count_);
+    }
+
+    void addBytes(unsigned char const * data, size_t size)
+    {
+      out_.insert(out_.end(), data, data + size);
+    }
+
+  private:
+    std::vector<unsigned char> & out_;
+    unsigned bits_;
+    int count_;
+  };
+
+  // Literal/length symbol with fixed Huffman code
+  void addFixedSymbol(BitWriter & out, unsigned symbol)
+  {
+    if (symbol <= 143)
+      out.addHuffman(0x30 + symbol, 8);
+    else if (symbol <= 255)
+      out.addHuffman(0x190 + symbol - 144, 9);
+    else if (symbol <= 279)
+      out.addHuffman(symbol - 256, 7);
+    else
+      out.addHuffman(0xc0 + symbol - 280, 8);
+  }
+
+  unsigned short const LengthBase[] = { 3,4,5,6,7,8,9,10,11,13,15,17,19,23,27,31,35,43,51,59,67,83,99,115,131,163,195,227,258 };
+  unsigned char const LengthExtraBits[] = { 0,0,0,0,0,0,0,0,1,1,1,1,2,2,2,2,3,3,3,3,4,4,4,4,5,5,5,5,0 };
+  unsigned short const DistanceBase[] = { 1,2,3,4,5,7,9,13,17,25,33,49,65,97,129,193,257,385,513,769,1025,1537,2049,3073,4097,6145,8193,12289,16385,24577 };
+  unsigned char const DistanceExtraBits[] = { 0,0,0,0,1,1,2,2,3,3,4,4,5,5,6,6,7,7,8,8,9,9,10,10,11,11,12,12,13,13 };
+
+  void addMatch(BitWriter & out, unsigned length, unsigned distance)
+  {
+    int const l = int(std::upper_bound(LengthBase, LengthBase + 29, length) - LengthBase) - 1;
+    addFixedSymbol(out, 257 + l);
+    if (LengthExtraBits[l])
+      out.add(length - LengthBase[l], LengthExtraBits[l]);
+    int const d = int(std::upper_bound(DistanceBase, DistanceBase + 30, distance) - DistanceBase) - 1;
+    out.addHuffman(d, 5);
+    if (DistanceExtraBits[d])
+      out.add(distance - DistanceBase[d], DistanceExtraBits[d]);
+  }
+
+  // LZ77 with hash chains limited to max_chain candidates, encoded with fixed Huffman codes.
+  // Matches don't reach outside of data, so blocks of different strips are independent
+  void deflateFixed(BitWriter & out, unsigned char const * data, size_t size, int max_chain)
+  {
+    static const int HashBits = 15;
+    static const size_t WindowSize = 32768;
+    static const unsigned MaxMatch = 258;
+    std::vector<int> head(1 << HashBits, -1);
+    std::vector<int> prev(WindowSize);
+
+    size_t i = 0;
+    for(; i + 3 <= size; )
+    {
+      unsigned const hash = ((data[i] << 10) ^ (data[i + 1] << 5) ^ data[i + 2]) & ((1 << HashBits) - 1);
+      unsigned best_length = 0, best_distance = 0;
+      unsigned const max_length = unsigned(std::min<size_t>(MaxMatch, size - i));
+      int chain = max_chain;
+      for(int candidate = head[hash]; candidate >= 0 && i - candidate < WindowSize && chain > 0;
+        candidate = prev[candidate & (WindowSize - 1)], --chain)
+      {
+        unsigned length = 0;
+        while (length < max_length && data[candidate + length] == data[i + length])
+          ++length;
+        if (length > best_length)
+        {
+          best_length = length;
+          best_distance = unsigned(i - candidate);
+          if (length == max_length)
+            break;
+        }
+      }
+
+      unsigned const step = best_length >= 3 ? best_length : 1;
+      if (best_length >= 3)
+        addMatch(out, best_length, best_distance);
+      else
+        addFixedSymbol(out, data[i]);
+      // Positions covered by the match are added to hash chains too
+      size_t const next = i + step;
+      for(; i < next && i + 3 <= size; ++i)
+      {
+        unsigned const h = ((data[i] << 10) ^ (data[i + 1] << 5) ^ data[i + 2]) & ((1 << HashBits) - 1);
+        prev[i & (WindowSize - 1)] = head[h];
+        head[h] = int(i);
+      }
+      i = next;
+    }
+    for(; i < size; ++i)
+      addFixedSymbol(out, data[i]);
+  }
+
+  void storeBlocks(BitWriter & out, unsigned char const * data, size_t size, bool last)
+  {
+    do
+    {
+      size_t const block = std::min<size_t>(size, 65535);
+      out.add(last && block == size ? 1 : 0, 1);
+      out.add(0, 2); // BTYPE = 0 - stored
+      out.alignToByte();
+      unsigned char const header[] = {
+        static_cast<unsigned char>(block), static_cast<unsigned char>(block >> 8),
+        static_cast<unsigned char>(~block), static_cast<unsigned char>(~block >> 8) };
+      out.addBytes(header, 4);
+      out.addBytes(data, block);
+      data += block;
+      size -= block;
+    } while (size > 0);
+  }
+
+  unsigned char paeth(int a, int b, int c)
+  {
+    int const p = a + b - c, pa = std::abs(p - a), pb = std::abs(p - b), pc = std::abs(p - c);
+    if (pa <= pb && pa <= pc)
+      return static_cast<unsigned char>(a);
+    if (pb <= pc)
+      return static_cast<unsigned char>(b);
+    return static_cast<unsigned char>(c);
+  }
+
+  // PNG filter type values
+  enum { FilterNone, FilterSub, FilterUp, FilterAverage, FilterPaeth };
+
+  // prior is NULL for the first row of the image
+  void filterRow(int type, unsigned char const * row, unsigned char const * prior, size_t size, int bpp, unsigned char * out)
+  {
+    size_t i = 0;
+    switch (type)
+    {
+    case FilterNone:
+      std::copy(row, row + size, out);
+      break;
+    case FilterSub:
+      std::copy(row, row + bpp, out);
+      for(i = bpp; i < size; ++i)
+        out[i] = row[i] - row[i - bpp];
+      break;
+    case FilterUp:
+      if (!prior)
+        std::copy(row, row + size, out);
+      else
+        for(; i < size; ++i)
+          out[i] = row[i] - prior[i];
+      break;
+    case FilterAverage:
+      for(; i < size; ++i)
+        out[i] = row[i] - ((i >= size_t(bpp) ? row[i - bpp] : 0) + (prior ? prior[i] : 0)) / 2;
+      break;
+    case FilterPaeth:
+      for(; i < size; ++i)
+      {
+        int const a = i >= size_t(bpp) ? row[i - bpp] : 0;
+        int const b = prior ? prior[i] : 0;
+        int const c = prior && i >= size_t(bpp) ? prior[i - bpp] : 0;
+        out[i] = row[i] - paeth(a, b, c);
+      }
+      break;
+    }
+  }
+
+  class StripEncoder: boost::noncopyable
+  {
+  public:
+    StripEncoder(int width, int height, int components, unsigned char const * pixels, std::ptrdiff_t stride,
+        PngWriteOptions const & options)
+      : width_(width)
+      , height_(height)
+      , components_(components)
+      , pixels_(pixels)
+      , stride_(stride)
+      , options_(options)
+      , strip_rows_(std::max(1, options.strip_rows))
+      , strips_((height + strip_rows_ - 1) / strip_rows_)
+      , next_strip_(0)
+      , abort_(false)
+    {}
+
+    bool write(std::ostream & out)
+    {
+      unsigned thread_count = options_.threads ? options_.threads : std::thread::hardware_concurrency();
+      thread_count = std::max(1u, std::min(thread_count, unsigned(strips_.size())));
+      std::vector<std::thread> threads;
+      for(unsigned i = 0; i < thread_count; ++i)
+        threads.push_back(std::thread(&StripEncoder::work, this));
+
+      static unsigned char const signature[] = { 137, 80, 78, 71, 13, 10, 26, 10 };
+      static unsigned char const color_types[] = { 0, 0, 4, 2, 6 };
+      out.write(reinterpret_cast<char const *>(signature), sizeof(signature));
+      unsigned char header[13] = {};
+      putUInt32(header, width_);
+      putUInt32(header + 4, height_);
+      header[8] = 8;
+      header[9] = color_types[components_];
+      writeChunk(out, "IHDR", header, sizeof(header));
+      // zlib header: deflate with 32K window
+      static unsigned char const zlib_header[] = { 0x78, 0x5e };
+      writeChunk(out, "IDAT", zlib_header, sizeof(zlib_header));
+
+      unsigned long adler = 1;
+      bool ok = true;
+      for(size_t k = 0; k < strips_.size() && ok; ++k)
+      {
+        std::vector<unsigned char> data;
+        {
+          std::unique_lock<std::mutex> lock(mutex_);
+          while (!strips_[k].ready_)
+            strip_ready_.wait(lock);
+          ok = !strips_[k].failed_;
+          data.swap(strips_[k].data_);
+        }
+        adler = adler32Combine(adler, strips_[k].adler_, strips_[k].filtered_size_);
+        if (ok)
+        {
+          writeChunk(out, "IDAT", data.empty() ? NULL : &data[0], data.size());
+          ok = out.good();
+        }
+      }
+      if (!ok)
+      {
+        std::lock_guard<std::mutex> lock(mutex_);
+        abort_ = true;
+      }
+      for(size_t i = 0; i < threads.size(); ++i)
+        threads[i].join();
+      if (!ok)
+        return false;
+
+      unsigned char trailer[4];
+      putUInt32(trailer, adler);
+      writeChunk(out, "IDAT", trailer, sizeof(trailer));
+      writeChunk(out, "IEND", NULL, 0);
+      return out.good();
+    }
+
+  private:
+    struct Strip
+    {
+      Strip()
+        : ready_(false), failed_(false), adler_(1), filtered_size_(0)
+      {}
+
+      bool ready_, failed_;
+      std::vector<unsigned char> data_; // Deflate blocks
+      unsigned long adler_;
+      size_t filtered_size_;
+    };
+
+    int const width_, height_, components_;
+    unsigned char const * const pixels_;
+    std::ptrdiff_t const stride_;
+    PngWriteOptions const options_;
+    int const strip_rows_;
+    std::vector<Strip> strips_;
+    size_t next_strip_;
+    bool abort_;
+    std::mutex mutex_;
+    std::condition_variable strip_ready_;
+
+    void work()
+    {
+      for(;;)
+      {
+        size_t k;
+        {
+          std::lock_guard<std::mutex> lock(mutex_);
+          if (abort_ || next_strip_ == strips_.size())
+            return;
+          k = next_strip_++;
+        }
+        Strip result;
+        try
+        {
+          encodeStrip(k, result);
+        }
+        catch (std::exception const &)
+        {
+          result.failed_ = true;
+        }
+        {
+          std::lock_guard<std::mutex> lock(mutex_);
+          strips_[k].data_.swap(result.data_);
+          strips_[k].adler_ = result.adler_;
+          strips_[k].filtered_size_ = result.filtered_size_;
+          strips_[k].failed_ = result.failed_;
+          strips_[k].ready_ = true;
+        }
+        strip_ready_.notify_all();
+      }
+    }
+
+    void encodeStrip(size_t k, Strip & strip) const
+    {
+      int const first_row = int(k) * strip_rows_;
+      int const rows = std::min(strip_rows_, height_ - first_row);
+      size_t const row_size = size_t(width_) * components_;
+      std::vector<unsigned char> filtered(rows * (row_size + 1));
+      std::vector<unsigned char> candidate(options_.filter == PngFilterAdaptive ? row_size : 0);
+      for(int r = 0; r < rows; ++r)
+      {
+        int const y = first_row + r;
+        unsigned char const * row = pixels_ + y * stride_;
+        unsigned char const * prior = y > 0 ? row - stride_ : NULL;
+        unsigned char * out = &filtered[r * (row_size + 1)];
+        switch (options_.filter)
+        {
+        case PngFilterNone:
+          out[0] = FilterNone;
+          break;
+        case PngFilterSub:
+          out[0] = FilterSub;
+          break;
+        case PngFilterUp:
+          out[0] = FilterUp;
+          break;
+        case PngFilterAdaptive:
+        {
+          // Heuristic from PNG specification: minimal sum of absolute values of signed differences
+          unsigned long best_sum = 0;
+          for(int type = FilterNone; type <= FilterPaeth; ++type)
+          {
+            filterRow(type, row, prior, row_size, components_, row_size ? &candidate[0] : NULL);
+            unsigned long sum = 0;
+            for(size_t i = 0; i < row_size; ++i)
+              sum += std::abs(static_cast<signed char>(candidate[i]));
+            if (type == FilterNone || sum < best_sum)
+            {
+              best_sum = sum;
+              out[0] = static_cast<unsigned char>(type);
+              std::copy(candidate.begin(), candidate.end(), out + 1);
+            }
+          }
+          continue;
+        }
+        }
+        filterRow(out[0], row, prior, row_size, components_, out + 1);
+      }
+
+      strip.adler_ = adler32(1, filtered.empty() ? NULL : &filtered[0], filtered.size());
+      strip.filtered_size_ = filtered.size();
+      bool const last = k + 1 == strips_.size();
+      BitWriter out(strip.data_);
+      if (options_.compression_level <= 0)
+      {
+        storeBlocks(out, filtered.empty() ? NULL : &filtered[0], filtered.size(), last);
+        return;
+      }
+      out.add(last ? 1 : 0, 1);
+      out.add(1, 2); // BTYPE = 1 - fixed Huffman codes
+      static int const max_chains[] = { 0, 2, 4, 6, 8, 12, 16, 32, 64, 256 };
+      deflateFixed(out, filtered.empty() ? NULL : &filtered[0], filtered.size(),
+        max_chains[std::min(options_.compression_level, 9)]);
+      addFixedSymbol(out, 256); // End of block
+      if (last)
+        out.alignToByte();
+      else
+        // Empty stored block aligns stream to byte boundary, so that the next strip can be appended
+        storeBlocks(out, NULL, 0, false);
+    }
+
+    static void putUInt32(unsigned char * out, unsigned long value)
+    {
+      out[0] = static_cast<unsigned char>(value >> 24);
+      out[1] = static_cast<unsigned char>(value >> 16);
+      out[2] = static_cast<unsigned char>(value >> 8);
+      out[3] = static_cast<unsigned char>(value);
+    }
+
+    static void writeChunk(std::ostream & out, char const * type, unsigned char const * data, size_t size)
+    {
+      unsigned char header[8];
+      putUInt32(header, static_cast<unsigned long>(size));
+      std::copy(type, type + 4, header + 4);
+      Crc32 crc;
+      crc.update(header + 4, 4);
+      crc.update(data, size);
+      unsigned char crc_bytes[4];
+      putUInt32(crc_bytes, crc.value());
+      out.write(reinterpret_cast<char const *>(header), sizeof(header));
+      out.write(reinterpret_cast<char const *>(data), size);
+      out.write(reinterpret_cast<char const *>(crc_bytes), sizeof(crc_bytes));
+    }
+  };
+}
+
+bool writePng(const char * file_name, int width, int height, int components,
+  unsigned char const * pixels, std::ptrdiff_t stride, PngWriteOptions const & options)
+{
+  if (width <= 0 || height <= 0 || components < 1 || components > 4)
+    return false;
+  std::ofstream out(file_name, std::ios::binary);
+  if (!out)
+    return false;
+  StripEncoder encoder(width, height, components, pixels, stride, options);
+  return encoder.write(out);
+}
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <cstddef>
+
+enum PngFilterStrategy
+{
+  PngFilterNone,      // Fastest, largest output
+  PngFilterSub,       // Fast, good for thumbnails
+  PngFilterUp,
+  PngFilterAdaptive   // Filter with minimal sum of absolute differences is chosen for each row
+};
+
+struct PngWriteOptions
+{
+  // Level 0 stores data uncompressed, 1-3 are fast modes, up to 9 trade speed for size
+  explicit PngWriteOptions(int level = 6)
+    : compression_level(level)
+    , filter(level == 0 ? PngFilterNone : level < 4 ? PngFilterSub : PngFilterAdaptive)
+    , strip_rows(64)
+    , threads(0)
+  {}
+
+  int compression_level;
+  PngFilterStrategy filter;
+  int strip_rows;   // Rows in independently compressed strip
+  unsigned threads; // Encoding threads, 0 - one per hardware thread
+};
+
+// Writes 8 bit image with 1-4 components (gray, gray+alpha, RGB, RGBA).
+// Strips of rows are filtered and compressed in parallel as separate deflate blocks of the
+// single zlib stream and are written to the file in order as soon as they are ready.
+// Returns false on error
+bool writePng(const char * file_name, int width, int height, int components,
+  unsigned char const * pixels, std::ptrdiff_t stride, PngWriteOptions const & options = PngWriteOptions());
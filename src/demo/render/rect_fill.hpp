@@ -0,0 +1,39 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <agg_basics.h>
+
+template<class Number>
+inline agg::int8u RectCover(Number coverage)
+{
+  return agg::int8u(coverage * agg::cover_full + 0.5);
+}
+
+// Fills rectangle given in buffer coordinates. Coverage of the edge pixels is the exact area
+// of the pixel covered, inner pixels are blitted by spans without rasterization
+template<class RendererBase, class Number>
+void FillAxisAlignedRect(RendererBase & renderer, typename RendererBase::color_type const & color,
+  Number x1, Number y1, Number x2, Number y2)
+{
+  x1 = std::max<Number>(x1, renderer.xmin());
+  y1 = std::max<Number>(y1, renderer.ymin());
+  x2 = std::min<Number>(x2, renderer.xmax() + 1);
+  y2 = std::min<Number>(y2, renderer.ymax() + 1);
+  if (x1 >= x2 || y1 >= y2)
+    return;
+  int const first_x = int(std::floor(x1)), last_x = int(std::ceil(x2)) - 1;
+  int const first_y = int(std::floor(y1)), last_y = int(std::ceil(y2)) - 1;
+  Number const left_coverage = first_x == last_x ? x2 - x1 : first_x + 1 - x1;
+  Number const right_coverage = x2 - last_x;
+  for(int y = first_y; y <= last_y; ++y)
+  {
+    Number const row_coverage = std::min<Number>(y + 1, y2) - std::max<Number>(y, y1);
+    renderer.blend_pixel(first_x, y, color, RectCover(left_coverage * row_coverage));
+    if (first_x == last_x)
+      continue;
+    if (last_x - first_x > 1)
+      renderer.blend_hline(first_x + 1, y, last_x - 1, color, RectCover(row_coverage));
+    renderer.blend_pixel(last_x, y, color, RectCover(right_coverage * row_coverage));
+  }
+}
@@ -0,0 +1,88 @@
+#include "rect_fill.hpp"
+
+#include <agg_pixfmt_rgba.h>
+#include <agg_rasterizer_scanline_aa.h>
+#include <agg_renderer_base.h>
+#include <agg_renderer_scanline.h>
+#include <agg_rendering_buffer.h>
+#include <agg_scanline_p.h>
+#include <gtest/gtest.h>
+#include <cstdlib>
+#include <vector>
+
+namespace
+{
+  const int BufferSize = 16;
+
+  class TestBuffer
+  {
+  public:
+    TestBuffer()
+      : data_(BufferSize * BufferSize * 4, 0)
+      , rbuf_(&data_[0], BufferSize, BufferSize, BufferSize * 4)
+      , pixfmt_(rbuf_)
+      , renderer_(pixfmt_)
+    {}
+
+    agg::renderer_base<agg::pixfmt_rgba32> & renderer() { return renderer_; }
+    std::vector<agg::int8u> const & data() const { return data_; }
+
+  private:
+    std::vector<agg::int8u> data_;
+    agg::rendering_buffer rbuf_;
+    agg::pixfmt_rgba32 pixfmt_;
+    agg::renderer_base<agg::pixfmt_rgba32> renderer_;
+  };
+
+  void FillByRasterizer(agg::renderer_base<agg::pixfmt_rgba32> & renderer, agg::rgba8 const & color,
+    double x1, double y1, double x2, double y2)
+  {
+    agg::rasterizer_scanline_aa<> rasterizer;
+    rasterizer.move_to_d(x1, y1);
+    rasterizer.line_to_d(x2, y1);
+    rasterizer.line_to_d(x2, y2);
+    rasterizer.line_to_d(x1, y2);
+    agg::scanline_p8 scanline;
+    agg::render_scanlines_aa_solid(rasterizer, scanline, renderer, color);
+  }
+
+  void CheckRect(double x1, double y1, double x2, double y2)
+  {
+    agg::rgba8 const color(40, 120, 200, 255);
+    TestBuffer expected, actual;
+    FillByRasterizer(expected.renderer(), color, x1, y1, x2, y2);
+    FillAxisAlignedRect(actual.renderer(), color, x1, y1, x2, y2);
+    // Rasterizer computes coverage with 8 bit subpixel accuracy
+    for(size_t i = 0; i < expected.data().size(); ++i)
+      ASSERT_LE(std::abs(int(expected.data()[i]) - int(actual.data()[i])), 2)
+        << "rect (" << x1 << ", " << y1 << ") - (" << x2 << ", " << y2 << "), "
+        << "pixel (" << (i / 4) % BufferSize << ", " << (i / 4) / BufferSize << ")";
+  }
+}
+
+TEST(FillAxisAlignedRect, MatchesRasterizer)
+{
+  double const offsets[] = { 0, 0.25, 0.5, 0.75 };
+  double const sizes[] = { 0.25, 0.5, 1, 1.5, 2.75, 7 };
+  for(int xo = 0; xo < 4; ++xo)
+    for(int yo = 0; yo < 4; ++yo)
+      for(int w = 0; w < 6; ++w)
+        for(int h = 0; h < 6; ++h)
+        {
+          double const x1 = 3 + offsets[xo], y1 = 5 + offsets[yo];
+          CheckRect(x1, y1, x1 + sizes[w], y1 + sizes[h]);
+        }
+}
+
+TEST(FillAxisAlignedRect, ClippedByBuffer)
+{
+  CheckRect(-2.5, -1.25, 4.5, 3.75);
+  CheckRect(12.25, 10.5, 20, 17.75);
+  CheckRect(-5, -5, 21, 21);
+}
+
+TEST(FillAxisAlignedRect, OutsideOfBuffer)
+{
+  CheckRect(-5, 2, -1, 6);
+  CheckRect(17, 2, 20, 6);
+}
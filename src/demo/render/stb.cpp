@@ -1,4 +0,0 @@
-// Module for stb library implementation
-
-#define STB_IMAGE_WRITE_IMPLEMENTATION
-#include <stb/stb_image_write.h>
\ No newline at end of file
@@ -7,6 +7,7 @@
 #include <svgpp/utility/gil/mask.hpp>
 
 #include <boost/bind.hpp>
+#include <boost/functional/hash.hpp>
 #include <boost/gil/gil_all.hpp>
 #include <boost/mpl/set.hpp>
 #include <boost/mpl/transform_view.hpp>
@@ -27,11 +28,12 @@
 #include <agg_conv_curve.h>
 #include <agg_conv_dash.h>
 #include <agg_path_storage.h>
+#include <agg_rasterizer_outline_aa.h>
+#include <agg_renderer_outline_aa.h>
 #include <agg_pixfmt_amask_adaptor.h>
 #include <agg_span_allocator.h>
-#include <agg_span_gradient.h>
-#include <agg_span_interpolator_linear.h>
-#include <stb/stb_image_write.h>
+#include "png_writer.hpp"
+#include "rect_fill.hpp"
 #elif defined(RENDERER_SKIA)
 #include <SkBitmap.h>
 #include <SkCanvas.h>
@@ -42,6 +44,8 @@
 #include <images/SkForceLinking.h>
 #endif
 
+#include <cstdlib>
+#include <list>
 #include <map>
 #include <set>
 #include <fstream>
@@ -63,6 +67,7 @@ namespace boost {
 }
 
 
+class ImageBuffer;
 class Transformable;
 class Canvas;
 class Path;
@@ -87,6 +92,34 @@ struct Document
   Filters filters_;
   typedef std::set<XMLElement> followed_refs_t;
   followed_refs_t followed_refs_;
+
+  // Rendered masks, reused when the same mask is applied with the same transform and clipping to the same area
+  struct CachedMask
+  {
+    svg_string_t id;
+    boost::array<number_t, 6> transform;
+    PixelRect rect;
+    boost::shared_ptr<ClipBuffer> clip_buffer;
+    boost::shared_ptr<ImageBuffer> buffer;
+  };
+  typedef std::list<CachedMask> mask_cache_t;
+  static const size_t MaxCachedMasks = 8;
+  mask_cache_t mask_cache_; // Most recently used first
+#if defined(RENDERER_AGG)
+
+  // Stroke outlines in user coordinates, reused when the same path geometry is stroked 
+  // with the same parameters (e.g. when referenced by 'use' or drawn as marker)
+  struct CachedStroke
+  {
+    std::size_t hash; // Of geometry and params, compared before the full key
+    std::vector<number_t> geometry; // Commands and coordinates of the path
+    std::vector<number_t> params;
+    boost::shared_ptr<agg::path_storage> outline;
+  };
+  typedef std::list<CachedStroke> stroke_cache_t;
+  static const size_t MaxCachedStrokes = 32;
+  stroke_cache_t stroke_cache_; // Most recently used first
+#endif
 };
 
 class Document::FollowRef
@@ -301,13 +334,27 @@ class ImageBuffer: boost::noncopyable
 {
 public:
   ImageBuffer()
+    : x_(0), y_(0)
   {}
 
   ImageBuffer(int width, int height)
+    : x_(0), y_(0)
   {
     setSize(width, height, TransparentBlackColor());
   }
 
+  // Layer that covers only part of the canvas
+  explicit ImageBuffer(PixelRect const & rect)
+    : x_(rect.x1), y_(rect.y1)
+  {
+    setSize(rect.width(), rect.height(), TransparentBlackColor());
+  }
+
+  // Position of the top left pixel in canvas coordinates
+  int x() const { return x_; }
+  int y() const { return y_; }
+  PixelRect rect() const { return PixelRect(x_, y_, x_ + width(), y_ + height()); }
+
 #if defined(RENDERER_AGG)
   int width() const { return pixfmt_.width(); }
   int height() const { return pixfmt_.height(); }
@@ -362,6 +409,7 @@ public:
   }
 
 private:
+  int x_, y_;
 #if defined(RENDERER_AGG)
   std::vector<unsigned char> buffer_;
   agg::rendering_buffer rbuf_;
@@ -461,10 +509,71 @@ private:
   transform_t transform_;
 };
 
-typedef boost::function<ImageBuffer&()> lazy_buffer_t;
+// Returns buffer that covers at least requested rectangle (if it is inside canvas).
+// Second parameter is number of levels which opacity is already applied by the caller
+typedef boost::function<ImageBuffer&(PixelRect const &, int)> lazy_buffer_t;
 
 namespace
 {
+  // Bounding box of transformed rectangle
+  PixelRect transformedBounds(transform_t const & transform, 
+    number_t min_x, number_t min_y, number_t max_x, number_t max_y)
+  {
+    number_t const corners_x[] = { min_x, max_x, max_x, min_x };
+    number_t const corners_y[] = { min_y, min_y, max_y, max_y };
+    number_t x1 = 0, y1 = 0, x2 = 0, y2 = 0;
+    for(int i = 0; i < 4; ++i)
+    {
+#if defined(RENDERER_AGG)
+      number_t x = corners_x[i], y = corners_y[i];
+      transform.transform(&x, &y);
+#elif defined(RENDERER_GDIPLUS)
+      Gdiplus::REAL m[6];
+      transform.GetElements(m);
+      number_t x = m[0] * corners_x[i] + m[2] * corners_y[i] + m[4];
+      number_t y = m[1] * corners_x[i] + m[3] * corners_y[i] + m[5];
+#elif defined(RENDERER_SKIA)
+      SkPoint pt;
+      transform.mapXY(corners_x[i], corners_y[i], &pt);
+      number_t x = pt.x(), y = pt.y();
+#endif
+      if (i == 0)
+      {
+        x1 = x2 = x;
+        y1 = y2 = y;
+      }
+      else
+      {
+        x1 = std::min(x1, x);
+        y1 = std::min(y1, y);
+        x2 = std::max(x2, x);
+        y2 = std::max(y2, y);
+      }
+    }
+    return PixelRect::bounding(x1, y1, x2, y2);
+  }
+
+  // Affine transform coefficients in SVG matrix order
+  boost::array<number_t, 6> transformElements(transform_t const & transform)
+  {
+    boost::array<number_t, 6> elements;
+#if defined(RENDERER_AGG)
+    transform.store_to(elements.data());
+#elif defined(RENDERER_GDIPLUS)
+    transform.GetElements(elements.data());
+#elif defined(RENDERER_SKIA)
+    transform.asAffine(elements.data());
+#endif
+    return elements;
+  }
+
+  // Part of the buffer's view covering the rect in canvas coordinates
+  template<class View>
+  View subimage(View const & view, int view_x, int view_y, PixelRect const & rect)
+  {
+    return boost::gil::subimage_view(view, rect.x1 - view_x, rect.y1 - view_y, rect.width(), rect.height());
+  }
+
   template<class GrayMask>
   void blend_image_with_mask(boost::gil::rgba8_view_t const & rgbaView, GrayMask const & maskView)
   {
@@ -480,6 +589,29 @@ namespace
     }
     BOOST_ASSERT(o == rgbaView.end());
   }
+
+  // Same as blend_image_with_mask with color_converted_view of the RGBA mask through 
+  // rgba_to_mask_color_converter, but processes rows and skips transparent pixels
+  void blend_image_with_rgba_mask(boost::gil::rgba8_view_t const & rgbaView, boost::gil::rgba8_view_t const & maskView)
+  {
+    using namespace boost::gil;
+    BOOST_ASSERT(rgbaView.dimensions() == maskView.dimensions());
+    for(std::ptrdiff_t y = 0; y < rgbaView.height(); ++y)
+    {
+      rgba8_view_t::x_iterator m = maskView.row_begin(y);
+      for(rgba8_view_t::x_iterator o = rgbaView.row_begin(y), end = rgbaView.row_end(y); o != end; ++o, ++m)
+      {
+        boost::uint8_t & alpha = get_color(*o, alpha_t());
+        if (alpha == 0)
+          continue;
+        alpha = channel_multiply(alpha, 
+          channel_multiply(
+            svgpp::gil_detail::rgb_to_luminance<boost::uint8_t>(
+              get_color(*m, red_t()), get_color(*m, green_t()), get_color(*m, blue_t())),
+            get_color(*m, alpha_t())));
+      }
+    }
+  }
 }
 
 class Canvas: 
@@ -491,33 +623,72 @@ public:
 
   Canvas(Document & document, ImageBuffer & image_buffer)
     : document_(document)
-    , parent_buffer_(boost::bind(&Canvas::getPassedImageBuffer, this))
+    , parent_buffer_(boost::bind(&Canvas::getPassedImageBuffer, this, _1, _2))
     , image_buffer_(&image_buffer)
     , rendering_disabled_(false)
+    , child_elements_(0)
+    , single_child_element_(false)
+    , folded_levels_(0)
+    , folded_opacity_(1)
   {
     if (image_buffer.isSizeSet())
+    {
       clip_buffer_.reset(new ClipBuffer(image_buffer_->width(), image_buffer_->height()));
+      layer_limit_ = image_buffer_->rect();
+    }
   }
 
+  // Image buffer may cover only part of the canvas, clip buffer must cover the whole canvas
+  Canvas(Document & document, ImageBuffer & image_buffer, boost::shared_ptr<ClipBuffer> const & clip_buffer)
+    : document_(document)
+    , parent_buffer_(boost::bind(&Canvas::getPassedImageBuffer, this, _1, _2))
+    , image_buffer_(&image_buffer)
+    , clip_buffer_(clip_buffer)
+    , layer_limit_(image_buffer.rect())
+    , rendering_disabled_(false)
+    , child_elements_(0)
+    , single_child_element_(false)
+    , folded_levels_(0)
+    , folded_opacity_(1)
+  {}
+
   Canvas(Canvas & parent)
     : Transformable(parent)
     , Stylable(parent)
     , document_(parent.document_)
     , image_buffer_(NULL)
-    , parent_buffer_(boost::bind(&Canvas::getImageBuffer, &parent))
+    , parent_buffer_(boost::bind(&Canvas::getImageBuffer, &parent, _1, _2))
     , length_factory_(parent.length_factory_)
     , clip_buffer_(parent.clip_buffer_)
+    , layer_limit_(parent.layer_limit_)
     , rendering_disabled_(false)
-  {}
+    , child_elements_(0)
+    , single_child_element_(false)
+    , folded_levels_(0)
+    , folded_opacity_(1)
+  {
+    // If this element is the only content of the parent, then the parent's opacity can be applied
+    // to this element's content instead of compositing the parent's layer
+    if (parent.single_child_element_ && parent.onlyOpacityRequiresLayer())
+    {
+      folded_levels_ = parent.folded_levels_ + 1;
+      folded_opacity_ = parent.folded_opacity_ * parent.style().opacity_;
+    }
+  }
 
   Canvas(Canvas & parent, dontInheritStyle)
     : Transformable(parent)
     , document_(parent.document_)
     , image_buffer_(NULL)
-    , parent_buffer_(boost::bind(&Canvas::getImageBuffer, &parent))
+    , parent_buffer_(boost::bind(&Canvas::getImageBuffer, &parent, _1, _2))
     , length_factory_(parent.length_factory_)
     , clip_buffer_(parent.clip_buffer_)
+    , layer_limit_(parent.layer_limit_)
     , rendering_disabled_(false)
+    , child_elements_(0)
+    , single_child_element_(false)
+    , folded_levels_(0)
+    , folded_opacity_(1)
   {}
 
   void on_exit_element()
@@ -533,27 +704,17 @@ public:
       clip_buffer_->intersectClipPath(document().xml_document_, *style().clip_path_fragment_, transform());
     }
 
+    PixelRect const layer_rect = own_buffer_->rect();
     if (clip_buffer_)
-      blend_image_with_mask(own_buffer_->gilView(), clip_buffer_->gilView());
+      blend_image_with_mask(own_buffer_->gilView(), subimage(clip_buffer_->gilView(), 0, 0, layer_rect));
 
     if (style().mask_fragment_)
-    {
-      ImageBuffer & parent_buffer = parent_buffer_();
-      ImageBuffer mask_buffer(parent_buffer.width(), parent_buffer.height());
-      loadMask(mask_buffer);
-      typedef boost::gil::color_converted_view_type<
-        boost::gil::rgba8_view_t, 
-        boost::gil::gray8_pixel_t, 
-        svgpp::gil_utility::rgba_to_mask_color_converter<> 
-      >::type mask_view_t;
-      mask_view_t mask_view = boost::gil::color_converted_view<boost::gil::gray8_pixel_t>(
-        mask_buffer.gilView(), svgpp::gil_utility::rgba_to_mask_color_converter<>());
-
-      blend_image_with_mask(own_buffer_->gilView(), mask_view);
-    }
+      blend_image_with_rgba_mask(own_buffer_->gilView(), loadMask(layer_rect).gilView());
+    ImageBuffer & parent_buffer = parent_buffer_(layer_rect, 0);
+    int const dx = layer_rect.x1 - parent_buffer.x(), dy = layer_rect.y1 - parent_buffer.y();
 #if defined(RENDERER_AGG)
-    agg::renderer_base<pixfmt_t> renderer_base(parent_buffer_().pixfmt());
-    renderer_base.blend_from(own_buffer_->pixfmt(), NULL, 0, 0, unsigned(style().opacity_ * 255));
+    agg::renderer_base<pixfmt_t> renderer_base(parent_buffer.pixfmt());
+    renderer_base.blend_from(own_buffer_->pixfmt(), NULL, dx, dy, unsigned(style().opacity_ * 255));
 #elif defined(RENDERER_GDIPLUS)
     {
       Gdiplus::ColorMatrix color_matrix[] = { 
@@ -564,20 +725,20 @@ public:
         0.0f, 0.0f, 0.0f, 0.0f, 1.0f };
       Gdiplus::ImageAttributes ImgAttr;
       ImgAttr.SetColorMatrix(color_matrix, Gdiplus::ColorMatrixFlagsDefault, Gdiplus::ColorAdjustTypeBitmap);
-      Gdiplus::Graphics graphics(&parent_buffer_().bitmap());
+      Gdiplus::Graphics graphics(&parent_buffer.bitmap());
       graphics.DrawImage(
         &own_buffer_->bitmap(), 
-        Gdiplus::Rect(0, 0, own_buffer_->width(), own_buffer_->height()), 
+        Gdiplus::Rect(dx, dy, own_buffer_->width(), own_buffer_->height()), 
         0, 0, own_buffer_->width(), own_buffer_->height(),
         Gdiplus::UnitPixel, &ImgAttr);
     }
 #elif defined(RENDERER_SKIA)
     {
-      SkCanvas canvas(parent_buffer_().bitmap());
+      SkCanvas canvas(parent_buffer.bitmap());
       SkPaint paint;
       paint.setStyle(SkPaint::kFill_Style);
       paint.setAlpha(style().opacity_ * 255);
-      canvas.drawBitmap(own_buffer_->bitmap(), 0, 0, &paint);
+      canvas.drawBitmap(own_buffer_->bitmap(), dx, dy, &paint);
     }
 #endif
   }
@@ -588,6 +749,7 @@ public:
     {
       image_buffer_->setSize(viewport_width + 1.0, viewport_height + 1.0, TransparentWhiteColor());
       clip_buffer_.reset(new ClipBuffer(image_buffer_->width(), image_buffer_->height()));
+      layer_limit_ = image_buffer_->rect();
     }
     else
     {
@@ -613,6 +775,12 @@ public:
   bool rendering_disabled() const
   { return rendering_disabled_; }
 
+  void on_child_element(bool is_last_child)
+  { 
+    single_child_element_ = child_elements_ == 0 && is_last_child; 
+    ++child_elements_;
+  }
+
   length_factory_t & length_factory() 
   { return length_factory_; }
 
@@ -625,28 +793,73 @@ private:
   lazy_buffer_t parent_buffer_;
   std::auto_ptr<ImageBuffer> own_buffer_;
   boost::shared_ptr<ClipBuffer> clip_buffer_;
+  PixelRect layer_limit_; // Area of the canvas that may be drawn to
   length_factory_t length_factory_;
   bool rendering_disabled_;
+  int child_elements_;
+  bool single_child_element_;
+  int folded_levels_; // Number of ancestors, which opacity may be applied to the single primitive
+  number_t folded_opacity_; // Product of these ancestors opacities
 
-  void loadMask(ImageBuffer &) const;
+  ImageBuffer & loadMask(PixelRect const & rect) const;
   void applyFilter();
-  ImageBuffer & getPassedImageBuffer() { return *image_buffer_; }
+  ImageBuffer & getPassedImageBuffer(PixelRect const &, int) { return *image_buffer_; }
 
 protected:
-  ImageBuffer & getImageBuffer()
+  bool onlyOpacityRequiresLayer() const
   {
-    ImageBuffer & parent_buffer = parent_buffer_();
+    return !style().mask_fragment_ 
+      && !style().clip_path_fragment_ 
+      && !style().filter_;
+  }
+
+  // Opacity that the single primitive, drawn by this element, may apply itself instead of using layers.
+  // Number of levels that are folded this way must be passed to getImageBuffer
+  number_t foldedOpacity(int & folded_levels) const
+  {
+    if (!onlyOpacityRequiresLayer())
+    {
+      folded_levels = 0;
+      return 1;
+    }
+    folded_levels = folded_levels_ + 1;
+    return folded_opacity_ * style().opacity_;
+  }
 
+  // Own layer is allocated only for the area that is drawn to and grows if needed
+  ImageBuffer & getImageBuffer(PixelRect const & rect, int folded_levels = 0)
+  {
+    if (folded_levels > 0)
+    {
+      BOOST_ASSERT(onlyOpacityRequiresLayer());
+      return parent_buffer_(rect, folded_levels - 1);
+    }
     if (style().opacity_ < 0.999 
       || style().mask_fragment_ 
       || style().clip_path_fragment_ 
       || style().filter_)
     {
-      if (!own_buffer_.get())
-        own_buffer_.reset(new ImageBuffer(parent_buffer.width(), parent_buffer.height()));
+      PixelRect limit = layer_limit_;
+      if (clip_buffer_)
+        limit = limit.intersect(clip_buffer_->bounds());
+      // Filter primitives may use and produce pixels outside of the drawn area
+      PixelRect layer_rect = style().filter_ ? limit : rect.intersect(limit);
+      if (own_buffer_.get())
+        layer_rect = layer_rect.unite(own_buffer_->rect());
+      else if (layer_rect.empty())
+        layer_rect = PixelRect(limit.x1, limit.y1, limit.x1 + 1, limit.y1 + 1);
+
+      if (!own_buffer_.get() || !own_buffer_->rect().contains(layer_rect))
+      {
+        std::auto_ptr<ImageBuffer> layer(new ImageBuffer(layer_rect));
+        if (own_buffer_.get())
+          boost::gil::copy_pixels(own_buffer_->gilView(), 
+            subimage(layer->gilView(), layer->x(), layer->y(), own_buffer_->rect()));
+        own_buffer_ = layer;
+      }
       return *own_buffer_;
     }
-    return parent_buffer;
+    return parent_buffer_(rect, 0);
   }
 
   Document & document() const { return document_; }
@@ -671,9 +884,11 @@ void Canvas::applyFilter()
   if (!style().filter_)
     return;
 
+  ImageBuffer & parent_buffer = parent_buffer_(own_buffer_->rect(), 0);
   Filters::Input in;
   in.sourceGraphic_ = IFilterViewPtr(new SimpleFilterView(own_buffer_->gilView()));
-  in.backgroundImage_ = IFilterViewPtr(new SimpleFilterView(parent_buffer_().gilView()));
+  in.backgroundImage_ = IFilterViewPtr(new SimpleFilterView(
+    subimage(parent_buffer.gilView(), parent_buffer.x(), parent_buffer.y(), own_buffer_->rect())));
   IFilterViewPtr out = document_.filters_.get(*style().filter_, length_factory_, in);
   if (out)
     boost::gil::copy_pixels(out->view(), own_buffer_->gilView());
@@ -853,12 +1068,30 @@ private:
 
   typedef boost::variant<svgpp::tag::value::none, color_t, Gradient> EffectivePaint;
 #if defined(RENDERER_AGG)
+  static bool nearlyEqual(number_t a, number_t b)
+  {
+    return std::abs(a - b) <= 1e-9 * (std::abs(a) + std::abs(b));
+  }
+
+  // Returns device coordinates of the path if it is rectangle with sides parallel to the axes
+  bool axisAlignedRect(transform_t const & device_transform, 
+    number_t & x1, number_t & y1, number_t & x2, number_t & y2) const;
   template<class VertexSource>
-  void paintScanlines(EffectivePaint const & paint, number_t opacity, agg::rasterizer_scanline_aa<> & rasterizer,
+  void paintScanlines(ImageBuffer & buffer, transform_t const & device_transform,
+    EffectivePaint const & paint, number_t opacity, agg::rasterizer_scanline_aa<> & rasterizer,
     VertexSource & curved);
   template<class VertexSourceStroked, class VertexSourceCurved>
-  void strokePath(EffectivePaint const & stroke, VertexSourceStroked & curved_stroked, VertexSourceCurved & curved);
+  void strokePath(ImageBuffer & buffer, transform_t const & device_transform,
+    EffectivePaint const & stroke, number_t opacity, VertexSourceStroked & curved_stroked, VertexSourceCurved & curved);
+  template<class VertexSource>
+  void strokeHairline(ImageBuffer & buffer, transform_t const & device_transform,
+    agg::rgba8 const & color, VertexSource & source);
+  // Cache slot for the stroke outline of the path, empty if outline is not generated yet
+  boost::shared_ptr<agg::path_storage> & cachedStrokeOutline();
+  bool sameGeometry(std::vector<number_t> const & geometry) const;
 #endif
+  PixelRect deviceBounds(bool stroked) const;
+  number_t foldedPaintOpacity(bool filled, bool stroked, int & folded_levels) const;
   void drawPath();
   void drawMarkers();
   void drawMarker(svg_string_t const & id, number_t x, number_t y, number_t dir);
@@ -892,6 +1125,16 @@ struct DocumentTraversalControl
   {
     return true;
   }
+
+  template<class XMLElement>
+  static bool process_child(Canvas & context, XMLElement const & xml_element)
+  {
+    typedef svgpp::policy::xml::element_iterator<XMLElement> xml_policy_t;
+    XMLElement next_element = xml_element;
+    xml_policy_t::advance_element(next_element);
+    context.on_child_element(xml_policy_t::is_end(next_element));
+    return true;
+  }
 };
 
 typedef 
@@ -1009,8 +1252,9 @@ private:
 class Mask: public Canvas
 {
 public:
-  Mask(Document & document, ImageBuffer & image_buffer, Transformable const & referenced)
-    : Canvas(document, image_buffer)
+  Mask(Document & document, ImageBuffer & image_buffer, Transformable const & referenced, 
+    boost::shared_ptr<ClipBuffer> const & clip_buffer)
+    : Canvas(document, image_buffer, clip_buffer)
     , maskUseObjectBoundingBox_(true)
     , maskContentUseObjectBoundingBox_(false)
   {
@@ -1058,17 +1302,34 @@ private:
   number_t x_, y_, width_, height_; // TODO: defaults
 };
 
-void Canvas::loadMask(ImageBuffer & mask_buffer) const
+ImageBuffer & Canvas::loadMask(PixelRect const & rect) const
 {
+  Document::mask_cache_t & cache = document().mask_cache_;
+  boost::array<number_t, 6> const transform_elements = transformElements(transform());
+  for(Document::mask_cache_t::iterator it = cache.begin(); it != cache.end(); ++it)
+    if (it->id == *style().mask_fragment_ && it->rect == rect 
+      && it->transform == transform_elements && it->clip_buffer == clip_buffer_)
+    {
+      cache.splice(cache.begin(), cache, it);
+      return *it->buffer;
+    }
+
+  boost::shared_ptr<ImageBuffer> mask_buffer(new ImageBuffer(rect));
   if (XMLElement element = document().xml_document_.findElementById(*style().mask_fragment_))
   {
     Document::FollowRef lock(document(), element);
 
-    Mask mask(document_, mask_buffer, *this);
+    Mask mask(document_, *mask_buffer, *this, clip_buffer_);
     document_traversal_main::load_expected_element(element, mask, svgpp::tag::element::mask());
   }
   else
     throw std::runtime_error("Element referenced by 'mask' not found");
+
+  Document::CachedMask const cached = { *style().mask_fragment_, transform_elements, rect, clip_buffer_, mask_buffer };
+  cache.push_front(cached);
+  if (cache.size() > Document::MaxCachedMasks)
+    cache.pop_back();
+  return *mask_buffer;
 }
 
 struct GradientBase_visitor: boost::static_visitor<>
@@ -1082,67 +1343,104 @@ struct GradientBase_visitor: boost::static_visitor<>
 };
 
 #if defined(RENDERER_AGG)
-template<class Gradient>
-class GradientRepeatAdapter
+// Gradient parameter for the row of pixels is calculated to the array in simple loops
+// that compiler is able to vectorize
+struct LinearGradientShape
 {
-public:
-  GradientRepeatAdapter(Gradient const & gradient, GradientBase::SpreadMethod method)
-    : gradient_(gradient)
-    , method_(method)
-  {}
+  static number_t screenLength(transform_t const & gradient_to_screen)
+  {
+    return std::sqrt(gradient_to_screen.sx * gradient_to_screen.sx + gradient_to_screen.shy * gradient_to_screen.shy);
+  }
 
-  int calculate(int x, int y, int d) const
+  // Gradient vector is (0, 0) - (1, 0)
+  void calculate(float x, float y, float dx, float dy, float * t, unsigned len) const
   {
-    int val = gradient_.calculate(x, y, d);
-    switch(method_)
-    {
-    default:
-      assert(false);
-    case GradientBase::spreadPad:
-    {
-      if (val < 0)
-        return 0;
-      if (val > d)
-        return d;
-      return val;
-    }
-    case GradientBase::spreadReflect:
+    for(unsigned i = 0; i < len; ++i)
+      t[i] = x + dx * float(i);
+  }
+};
+
+struct RadialGradientShape
+{
+  // Gradient circle has center (0, 0) and radius 1
+  RadialGradientShape(number_t fx, number_t fy)
+  {
+    // Focal point must be inside the circle
+    number_t const focus_distance = std::sqrt(fx * fx + fy * fy);
+    static const number_t max_focus_distance = 0.99;
+    if (focus_distance > max_focus_distance)
     {
-      int d2 = d * 2;
-      int ret = val % d2;
-      if (ret < 0) ret += d2;
-      if (ret >= d) ret = d2 - ret;
-      return ret;
+      fx *= max_focus_distance / focus_distance;
+      fy *= max_focus_distance / focus_distance;
     }
-    case GradientBase::spreadRepeat:
+    fx_ = float(fx);
+    fy_ = float(fy);
+    one_minus_f2_ = float(1 - fx * fx - fy * fy);
+  }
+
+  static number_t screenLength(transform_t const & gradient_to_screen)
+  {
+    return gradient_to_screen.scale();
+  }
+
+  // Ratio of distance from the focal point to the distance from focal point 
+  // to the circle in the same direction
+  void calculate(float x, float y, float dx, float dy, float * t, unsigned len) const
+  {
+    for(unsigned i = 0; i < len; ++i)
     {
-      int ret = val % d;
-      if (ret < 0) ret += d;
-      return ret;
-    }
+      float const px = x + dx * float(i) - fx_;
+      float const py = y + dy * float(i) - fy_;
+      float const fp = fx_ * px + fy_ * py;
+      float const p2 = px * px + py * py;
+      t[i] = p2 / (std::sqrt(fp * fp + p2 * one_minus_f2_) - fp + 1e-20f);
     }
   }
 
 private:
-  Gradient const & gradient_;
-  GradientBase::SpreadMethod const method_;
+  float fx_, fy_, one_minus_f2_;
 };
 
+struct SpreadPad
+{
+  static float apply(float t)
+  {
+    return t < 0.f ? 0.f : (t > 1.f ? 1.f : t);
+  }
+};
 
-struct ColorFunctionProfile
+struct SpreadReflect
+{
+  static float apply(float t)
+  {
+    t = std::fabs(t);
+    t -= 2.f * std::floor(t * 0.5f);
+    return t > 1.f ? 2.f - t : t;
+  }
+};
+
+struct SpreadRepeat
 {
-  static const unsigned size_ = 256;
+  static float apply(float t)
+  {
+    return t - std::floor(t);
+  }
+};
 
-  ColorFunctionProfile(GradientStops const & stops, number_t opacity) 
+struct ColorFunctionProfile
+{
+  // Size of the lookup table is chosen from the gradient length on screen
+  ColorFunctionProfile(GradientStops const & stops, number_t opacity, number_t screen_length) 
+    : colors_(tableSize(screen_length))
   {
     assert(stops.size() >= 2);
 
-    static const number_t offset_step = 1.0 / size_;
-    number_t offset = 0;
+    number_t const offset_step = 1.0 / (colors_.size() - 1);
     GradientStops::const_iterator stop1 = stops.begin(), stop2 = stops.begin();
     agg::rgba8 color1 = stopColor(*stop1, opacity), color2 = color1;
-    for(int i = 0; i < size_; ++i, offset += offset_step)
+    for(unsigned i = 0; i < colors_.size(); ++i)
     {
+      number_t const offset = i * offset_step;
       while(stop2 != stops.end() && offset > stop2->offset_)
       {
         stop1 = stop2;
@@ -1158,13 +1456,22 @@ struct ColorFunctionProfile
     }
   }
 
-  static unsigned size() { return size_; }
+  unsigned size() const { return colors_.size(); }
   const agg::rgba8 & operator[] (unsigned v) const
   {
     return colors_[v];
   }
 
 private:
+  static unsigned tableSize(number_t screen_length)
+  {
+    if (screen_length < 256)
+      return 256;
+    if (screen_length > 4096)
+      return 4096;
+    return unsigned(std::ceil(screen_length));
+  }
+
   static agg::rgba8 stopColor(GradientStop const & stop, number_t opacity)
   {
     if (opacity < 0.999)
@@ -1175,29 +1482,69 @@ private:
     return stop.color_;
   }
 
-  agg::rgba8 colors_[size_];
+  std::vector<agg::rgba8> colors_;
 };
 
-static const number_t GradientScale = 100.0;
+// AGG span generator
+template<class Shape, class Spread>
+class GradientSpanGenerator
+{
+public:
+  typedef agg::rgba8 color_type;
+
+  GradientSpanGenerator(transform_t const & screen_to_gradient, Shape const & shape, 
+    ColorFunctionProfile const & color_function)
+    : screen_to_gradient_(screen_to_gradient)
+    , shape_(shape)
+    , color_function_(color_function)
+  {}
+
+  void prepare() 
+  {}
 
-template<class GradientFunc, class VertexSource>
+  void generate(color_type * span, int x, int y, unsigned len)
+  {
+    // Gradient coordinates change linearly along the row
+    number_t gx = x + 0.5, gy = y + 0.5;
+    screen_to_gradient_.transform(&gx, &gy);
+    t_.resize(len);
+    shape_.calculate(float(gx), float(gy), 
+      float(screen_to_gradient_.sx), float(screen_to_gradient_.shy), &t_[0], len);
+
+    float const scale = float(color_function_.size() - 1);
+    for(unsigned i = 0; i < len; ++i)
+      span[i] = color_function_[unsigned(Spread::apply(t_[i]) * scale + 0.5f)];
+  }
+
+private:
+  transform_t const screen_to_gradient_;
+  Shape const shape_;
+  ColorFunctionProfile const & color_function_;
+  std::vector<float> t_;
+};
+
+template<class Shape, class Spread>
+void RenderScanlinesGradient(renderer_base_t & renderer, agg::rasterizer_scanline_aa<> & rasterizer,
+  Shape const & shape, transform_t const & screen_to_gradient, ColorFunctionProfile const & color_function)
+{
+  typedef GradientSpanGenerator<Shape, Spread> span_gradient_t;
+  typedef agg::span_allocator<typename span_gradient_t::color_type> span_allocator_t;
+
+  span_gradient_t span_gradient(screen_to_gradient, shape, color_function);
+  span_allocator_t span_allocator;
+  agg::scanline_p8 scanline;
+  agg::render_scanlines_aa(rasterizer, scanline, renderer, span_allocator, span_gradient);
+}
+
+template<class Shape, class VertexSource>
 void RenderScanlinesGradient(renderer_base_t & renderer, 
   agg::rasterizer_scanline_aa<> & rasterizer,
-  GradientFunc const & gradient_func, GradientBase const & gradient_base, 
+  Shape const & shape, GradientBase const & gradient_base, 
   transform_t const & user_transform, transform_t const & gradient_geometry_transform,
   number_t opacity,
   VertexSource & curved)
 {
-  typedef agg::span_interpolator_linear<> span_interpolator_t;
-  typedef GradientRepeatAdapter<GradientFunc> gradient_t;
-  typedef agg::span_gradient< 
-    agg::rgba8,
-    span_interpolator_t,
-    gradient_t,
-    ColorFunctionProfile > span_gradient_t;
-  typedef agg::span_allocator<typename span_gradient_t::color_type> span_allocator_t;
-
-  transform_t tr = agg::trans_affine_scaling(1.0/GradientScale) * gradient_geometry_transform;
+  transform_t tr = gradient_geometry_transform;
 
   if (gradient_base.matrix_)
     tr *= transform_t(gradient_base.matrix_->data());
@@ -1213,21 +1560,76 @@ void RenderScanlinesGradient(renderer_base_t & renderer,
   }
 
   tr *= user_transform;
+  ColorFunctionProfile color_function(gradient_base.stops_, opacity, Shape::screenLength(tr));
   tr.invert();
-  span_interpolator_t span_interpolator(tr);
-  ColorFunctionProfile color_function(gradient_base.stops_, opacity);
-  gradient_t gradient_repeated(gradient_func, gradient_base.spreadMethod_);
-  span_gradient_t span_gradient(span_interpolator, gradient_repeated, color_function, 0, GradientScale);
-  span_allocator_t span_allocator;
-  agg::scanline_p8 scanline;
-  agg::render_scanlines_aa(rasterizer, scanline, renderer, span_allocator, span_gradient);
+  // Spread method is resolved once, not per pixel
+  switch(gradient_base.spreadMethod_)
+  {
+  default:
+    BOOST_ASSERT(false);
+  case GradientBase::spreadPad:
+    RenderScanlinesGradient<Shape, SpreadPad>(renderer, rasterizer, shape, tr, color_function);
+    break;
+  case GradientBase::spreadReflect:
+    RenderScanlinesGradient<Shape, SpreadReflect>(renderer, rasterizer, shape, tr, color_function);
+    break;
+  case GradientBase::spreadRepeat:
+    RenderScanlinesGradient<Shape, SpreadRepeat>(renderer, rasterizer, shape, tr, color_function);
+    break;
+  }
+}
+
+bool Path::axisAlignedRect(transform_t const & device_transform, 
+  number_t & x1, number_t & y1, number_t & x2, number_t & y2) const
+{
+  if (device_transform.shx != 0 || device_transform.shy != 0)
+    return false;
+  // Expecting "move_to, 3 or 4 line_to, optional end_poly", i.e. what rect element with
+  // zero rx and ry or "M H V H Z" path produces
+  unsigned const total = path_storage_.total_vertices();
+  if (total < 4 || total > 6)
+    return false;
+  number_t px[6], py[6];
+  unsigned points = 0;
+  for(unsigned i = 0; i < total; ++i)
+  {
+    unsigned const cmd = path_storage_.vertex(i, &px[points], &py[points]);
+    if (i == 0 ? !agg::is_move_to(cmd) : agg::is_end_poly(cmd) ? i != total - 1 : !agg::is_line_to(cmd))
+      return false;
+    if (agg::is_vertex(cmd))
+      ++points;
+  }
+  if (points == 5)
+  {
+    if (!nearlyEqual(px[4], px[0]) || !nearlyEqual(py[4], py[0]))
+      return false;
+  }
+  else if (points != 4)
+    return false;
+  bool const horizontal_first = nearlyEqual(py[0], py[1]);
+  for(int i = 0; i < 4; ++i)
+  {
+    int const j = (i + 1) % 4;
+    if ((i % 2 == 0) == horizontal_first ? !nearlyEqual(py[i], py[j]) : !nearlyEqual(px[i], px[j]))
+      return false;
+  }
+  x1 = px[0] * device_transform.sx + device_transform.tx;
+  x2 = px[2] * device_transform.sx + device_transform.tx;
+  y1 = py[0] * device_transform.sy + device_transform.ty;
+  y2 = py[2] * device_transform.sy + device_transform.ty;
+  if (x1 > x2)
+    std::swap(x1, x2);
+  if (y1 > y2)
+    std::swap(y1, y2);
+  return true;
 }
 
 template<class VertexSource>
-void Path::paintScanlines(EffectivePaint const & paint, number_t opacity, agg::rasterizer_scanline_aa<> & rasterizer,
+void Path::paintScanlines(ImageBuffer & buffer, transform_t const & device_transform,
+  EffectivePaint const & paint, number_t opacity, agg::rasterizer_scanline_aa<> & rasterizer,
   VertexSource & curved) 
 {
-  renderer_base_t renderer_base(getImageBuffer().pixfmt());
+  renderer_base_t renderer_base(buffer.pixfmt());
   // TODO: pass bounding box function instead of curved
   if (agg::rgba8 const * paintColor = boost::get<agg::rgba8>(&paint))
   {
@@ -1244,7 +1646,6 @@ void Path::paintScanlines(EffectivePaint const & paint, number_t opacity, agg::r
     Gradient const & gradient = boost::get<Gradient const>(paint);
     if (LinearGradient const * linearGradient = boost::get<LinearGradient>(&gradient))
     {
-      agg::gradient_x gradient_func;
       number_t dx = linearGradient->x2_ - linearGradient->x1_;
       number_t dy = linearGradient->y2_ - linearGradient->y1_;
       transform_t gradient_geometry_transform = 
@@ -1252,48 +1653,136 @@ void Path::paintScanlines(EffectivePaint const & paint, number_t opacity, agg::r
         * agg::trans_affine_rotation(std::atan2(dy, dx))
         * agg::trans_affine_translation(linearGradient->x1_, linearGradient->y1_);
       RenderScanlinesGradient(renderer_base, rasterizer,
-        gradient_func, *linearGradient, transform(), gradient_geometry_transform, opacity, curved);
+        LinearGradientShape(), *linearGradient, device_transform, gradient_geometry_transform, opacity, curved);
     }
     else
     {
       RadialGradient const & radialGradient = boost::get<RadialGradient>(gradient);
-      agg::gradient_radial_focus gradient_func(GradientScale, 
-        GradientScale*(radialGradient.fx_ - radialGradient.cx_)/radialGradient.r_, 
-        GradientScale*(radialGradient.fy_ - radialGradient.cy_)/radialGradient.r_);
+      RadialGradientShape shape(
+        (radialGradient.fx_ - radialGradient.cx_)/radialGradient.r_, 
+        (radialGradient.fy_ - radialGradient.cy_)/radialGradient.r_);
       transform_t gradient_geometry_transform = 
         agg::trans_affine_scaling(radialGradient.r_)
         * agg::trans_affine_translation(radialGradient.cx_, radialGradient.cy_);
       RenderScanlinesGradient(renderer_base, rasterizer,
-        gradient_func, radialGradient, transform(), gradient_geometry_transform, opacity, curved);
+        shape, radialGradient, device_transform, gradient_geometry_transform, opacity, curved);
     }
   }
 }
 
-template<class VertexSourceStroked, class VertexSourceCurved>
-void Path::strokePath(EffectivePaint const & stroke, 
-  VertexSourceStroked & curved_stroked, VertexSourceCurved & curved) 
+// Strokes not wider than that on device are drawn as anti-aliased lines without outline generation
+number_t const HairlineMaxDeviceWidth = 1.5;
+
+boost::shared_ptr<agg::path_storage> & Path::cachedStrokeOutline()
 {
-  curved_stroked.width(style().stroke_width_);
-  curved_stroked.line_join(style().line_join_);
-  curved_stroked.line_cap(style().line_cap_);
-  curved_stroked.miter_limit(style().miterlimit_);
-  curved_stroked.inner_join(agg::inner_round);
-  curved_stroked.approximation_scale(transform().scale());
+  std::vector<number_t> params;
+  params.push_back(style().stroke_width_);
+  params.push_back(style().line_join_);
+  params.push_back(style().line_cap_);
+  params.push_back(style().miterlimit_);
+  params.push_back(transform().scale());
+  params.push_back(style().stroke_dashoffset_);
+  params.insert(params.end(), style().stroke_dasharray_.begin(), style().stroke_dasharray_.end());
+
+  unsigned const total_vertices = path_storage_.total_vertices();
+  std::size_t hash = boost::hash_range(params.begin(), params.end());
+  for(unsigned i = 0; i < total_vertices; ++i)
+  {
+    number_t x, y;
+    boost::hash_combine(hash, path_storage_.vertex(i, &x, &y));
+    boost::hash_combine(hash, x);
+    boost::hash_combine(hash, y);
+  }
+
+  Document::stroke_cache_t & cache = document().stroke_cache_;
+  for(Document::stroke_cache_t::iterator it = cache.begin(); it != cache.end(); ++it)
+    if (it->hash == hash && it->params == params && sameGeometry(it->geometry))
+    {
+      cache.splice(cache.begin(), cache, it);
+      return it->outline;
+    }
 
-  // If the *visual* line width is considerable we 
-  // turn on processing of curve cusps.
-  //---------------------
-  if(style().stroke_width_ * transform().scale() > 1.0)
+  cache.push_front(Document::CachedStroke());
+  Document::CachedStroke & entry = cache.front();
+  entry.hash = hash;
+  entry.params.swap(params);
+  entry.geometry.reserve(total_vertices * 3);
+  for(unsigned i = 0; i < total_vertices; ++i)
   {
-      curved.angle_tolerance(0.2);
+    number_t x, y;
+    entry.geometry.push_back(path_storage_.vertex(i, &x, &y));
+    entry.geometry.push_back(x);
+    entry.geometry.push_back(y);
+  }
+  if (cache.size() > Document::MaxCachedStrokes)
+    cache.pop_back();
+  return cache.front().outline;
+}
+
+bool Path::sameGeometry(std::vector<number_t> const & geometry) const
+{
+  if (geometry.size() != path_storage_.total_vertices() * 3)
+    return false;
+  for(unsigned i = 0; i < path_storage_.total_vertices(); ++i)
+  {
+    number_t x, y;
+    if (geometry[i * 3] != path_storage_.vertex(i, &x, &y)
+      || geometry[i * 3 + 1] != x || geometry[i * 3 + 2] != y)
+      return false;
   }
+  return true;
+}
 
-  typedef agg::conv_transform<VertexSourceStroked> transformed_t;
-  transformed_t curved_stroked_transformed(curved_stroked, transform());
+template<class VertexSourceStroked, class VertexSourceCurved>
+void Path::strokePath(ImageBuffer & buffer, transform_t const & device_transform,
+  EffectivePaint const & stroke, number_t opacity, VertexSourceStroked & curved_stroked, VertexSourceCurved & curved) 
+{
+  boost::shared_ptr<agg::path_storage> & outline = cachedStrokeOutline();
+  if (!outline)
+  {
+    curved_stroked.width(style().stroke_width_);
+    curved_stroked.line_join(style().line_join_);
+    curved_stroked.line_cap(style().line_cap_);
+    curved_stroked.miter_limit(style().miterlimit_);
+    curved_stroked.inner_join(agg::inner_round);
+    curved_stroked.approximation_scale(transform().scale());
+
+    // If the *visual* line width is considerable we 
+    // turn on processing of curve cusps.
+    //---------------------
+    if(style().stroke_width_ * transform().scale() > 1.0)
+    {
+        curved.angle_tolerance(0.2);
+    }
+
+    outline.reset(new agg::path_storage);
+    outline->concat_path(curved_stroked);
+  }
+
+  agg::conv_transform<agg::path_storage> outline_transformed(*outline, device_transform);
   agg::rasterizer_scanline_aa<> rasterizer;
   rasterizer.filling_rule(agg::fill_non_zero);
-  rasterizer.add_path(curved_stroked_transformed);
-  paintScanlines(stroke, style().stroke_opacity_, rasterizer, curved);
+  rasterizer.add_path(outline_transformed);
+  paintScanlines(buffer, device_transform, stroke, opacity, rasterizer, curved);
+}
+
+template<class VertexSource>
+void Path::strokeHairline(ImageBuffer & buffer, transform_t const & device_transform,
+  agg::rgba8 const & color, VertexSource & source)
+{
+  typedef agg::renderer_outline_aa<renderer_base_t> renderer_outline_t;
+  renderer_base_t renderer_base(buffer.pixfmt());
+  agg::line_profile_aa profile(style().stroke_width_ * transform().scale(), agg::gamma_none());
+  renderer_outline_t renderer(renderer_base, profile);
+  renderer.color(color);
+  renderer.clip_box(0, 0, buffer.width() - 1, buffer.height() - 1);
+  agg::rasterizer_outline_aa<renderer_outline_t> rasterizer(renderer);
+  // Joins other than round are indistinguishable at this width
+  rasterizer.line_join(style().line_join_ == agg::round_join 
+    ? agg::outline_round_join : agg::outline_miter_accurate_join);
+  rasterizer.round_cap(style().line_cap_ == agg::round_cap);
+  agg::conv_transform<VertexSource> transformed(source, device_transform);
+  rasterizer.add_path(transformed);
 }
 #elif defined(RENDERER_SKIA)
 void AssignGradientPaint(SkPaint & paint, SkPath const & path, Gradient const & gradient, SkMatrix transform)
@@ -1365,6 +1854,61 @@ void AssignGradientPaint(SkPaint & paint, SkPath const & path, Gradient const &
 }
 #endif
 
+PixelRect Path::deviceBounds(bool stroked) const
+{
+  // Bounds of control points contain curves
+  number_t min_x, min_y, max_x, max_y;
+#if defined(RENDERER_AGG)
+  if (!agg::bounding_rect_single(const_cast<agg::path_storage &>(path_storage_), 0, &min_x, &min_y, &max_x, &max_y))
+    return PixelRect();
+#elif defined(RENDERER_GDIPLUS)
+  if (path_points_.empty())
+    return PixelRect();
+  min_x = max_x = path_points_.front().X;
+  min_y = max_y = path_points_.front().Y;
+  for(std::vector<Gdiplus::PointF>::const_iterator pt = path_points_.begin(); pt != path_points_.end(); ++pt)
+  {
+    min_x = std::min(min_x, pt->X);
+    min_y = std::min(min_y, pt->Y);
+    max_x = std::max(max_x, pt->X);
+    max_y = std::max(max_y, pt->Y);
+  }
+#elif defined(RENDERER_SKIA)
+  SkRect const & bounds = path_.getBounds();
+  min_x = bounds.left();
+  min_y = bounds.top();
+  max_x = bounds.right();
+  max_y = bounds.bottom();
+#endif
+  if (stroked)
+  {
+    // Miter joins and square caps may extend further than half of stroke width
+#if defined(RENDERER_SKIA)
+    number_t const extent = style().skPaintStroke_.getStrokeWidth() 
+      * std::max(style().skPaintStroke_.getStrokeMiter(), SkScalar(1.5)) / 2;
+#else
+    number_t const extent = style().stroke_width_ * std::max(style().miterlimit_, number_t(1.5)) / 2;
+#endif
+    min_x -= extent;
+    min_y -= extent;
+    max_x += extent;
+    max_y += extent;
+  }
+  return transformedBounds(transform(), min_x, min_y, max_x, max_y);
+}
+
+number_t Path::foldedPaintOpacity(bool filled, bool stroked, int & folded_levels) const
+{
+  // Group opacity is equal to paint opacity only if parts of the group don't overlap
+  if ((filled && stroked) 
+    || (!markers_.empty() && (style().marker_start_ || style().marker_mid_ || style().marker_end_)))
+  {
+    folded_levels = 0;
+    return 1;
+  }
+  return foldedOpacity(folded_levels);
+}
+
 void Path::drawPath()
 {
 #if defined(RENDERER_AGG)
@@ -1379,9 +1923,28 @@ void Path::drawPath()
   path_storage_.arrange_orientations_all_paths(agg::path_flags_ccw); // TODO: move out
   
   EffectivePaint fill = getEffectivePaint(style().fill_paint_);
-  if (boost::get<svgpp::tag::value::none>(&fill) == NULL)
+  EffectivePaint stroke = getEffectivePaint(style().stroke_paint_);
+  bool const filled = boost::get<svgpp::tag::value::none>(&fill) == NULL;
+  bool const stroked = boost::get<svgpp::tag::value::none>(&stroke) == NULL;
+  if (!filled && !stroked)
+    return;
+  int folded_levels;
+  number_t const opacity = foldedPaintOpacity(filled, stroked, folded_levels);
+  ImageBuffer & buffer = getImageBuffer(deviceBounds(stroked), folded_levels);
+  transform_t const device_transform = transform() * agg::trans_affine_translation(-buffer.x(), -buffer.y());
+
+  number_t rect_x1, rect_y1, rect_x2, rect_y2;
+  agg::rgba8 const * fill_color = boost::get<agg::rgba8>(&fill);
+  if (fill_color && axisAlignedRect(device_transform, rect_x1, rect_y1, rect_x2, rect_y2))
   {
-    curved_transformed_t curved_transformed(curved, transform());
+    agg::rgba8 color(*fill_color);
+    color.opacity(style().fill_opacity_ * opacity);
+    renderer_base_t renderer_base(buffer.pixfmt());
+    FillAxisAlignedRect(renderer_base, color, rect_x1, rect_y1, rect_x2, rect_y2);
+  }
+  else if (filled)
+  {
+    curved_transformed_t curved_transformed(curved, device_transform);
     agg::rasterizer_scanline_aa<> rasterizer;
     rasterizer.filling_rule(style().nonzero_fill_rule_ ? agg::fill_non_zero : agg::fill_even_odd);
     //if(fabs(m_curved_trans_contour.width()) < 0.0001)
@@ -1394,17 +1957,33 @@ void Path::drawPath()
         ras.add_path(m_curved_trans_contour, attr.index);
     }*/
 
-    paintScanlines(fill, style().fill_opacity_, rasterizer, curved);
+    paintScanlines(buffer, device_transform, fill, style().fill_opacity_ * opacity, rasterizer, curved);
   }
 
-  EffectivePaint stroke = getEffectivePaint(style().stroke_paint_);
-  if (boost::get<svgpp::tag::value::none>(&stroke) == NULL)
+  if (stroked)
   {
+    agg::rgba8 hairline_color;
+    bool hairline = false;
+    if (agg::rgba8 const * stroke_color = boost::get<agg::rgba8>(&stroke))
+    {
+      number_t const device_width = style().stroke_width_ * transform().scale();
+      // Outline renderer has no square caps
+      hairline = device_width > 0 && device_width <= HairlineMaxDeviceWidth
+        && style().line_cap_ != agg::square_cap;
+      hairline_color = *stroke_color;
+      hairline_color.opacity(style().stroke_opacity_ * opacity);
+    }
+
     if (std::accumulate(style().stroke_dasharray_.begin(), style().stroke_dasharray_.end(), 0.0) <= 0.0)
     {
-      typedef agg::conv_stroke<curved_t> curved_stroked_t;
-      curved_stroked_t curved_stroked(curved);
-      strokePath(stroke, curved_stroked, curved);
+      if (hairline)
+        strokeHairline(buffer, device_transform, hairline_color, curved);
+      else
+      {
+        typedef agg::conv_stroke<curved_t> curved_stroked_t;
+        curved_stroked_t curved_stroked(curved);
+        strokePath(buffer, device_transform, stroke, style().stroke_opacity_ * opacity, curved_stroked, curved);
+      }
     }
     else
     {
@@ -1421,33 +2000,44 @@ void Path::drawPath()
 
       curved_dashed.dash_start(style().stroke_dashoffset_);
 
-      typedef agg::conv_stroke<curved_dashed_t> curved_stroked_t;
-      curved_stroked_t curved_stroked(curved_dashed);
-      strokePath(stroke, curved_stroked, curved);
+      if (hairline)
+        strokeHairline(buffer, device_transform, hairline_color, curved_dashed);
+      else
+      {
+        typedef agg::conv_stroke<curved_dashed_t> curved_stroked_t;
+        curved_stroked_t curved_stroked(curved_dashed);
+        strokePath(buffer, device_transform, stroke, style().stroke_opacity_ * opacity, curved_stroked, curved);
+      }
     }
   }
 #elif defined(RENDERER_GDIPLUS)
   if (path_points_.empty())
     return;
-  Gdiplus::Graphics graphics(&getImageBuffer().bitmap());
+  EffectivePaint fill = getEffectivePaint(style().fill_paint_);
+  EffectivePaint stroke = getEffectivePaint(style().stroke_paint_);
+  bool const filled = boost::get<svgpp::tag::value::none>(&fill) == NULL;
+  bool const stroked = boost::get<svgpp::tag::value::none>(&stroke) == NULL;
+  int folded_levels;
+  number_t const opacity = foldedPaintOpacity(filled, stroked, folded_levels);
+  ImageBuffer & buffer = getImageBuffer(deviceBounds(true), folded_levels);
+  Gdiplus::Graphics graphics(&buffer.bitmap());
   graphics.SetSmoothingMode(Gdiplus::SmoothingModeHighQuality);
   graphics.SetTransform(&transform());
+  graphics.TranslateTransform(-buffer.x(), -buffer.y(), Gdiplus::MatrixOrderAppend);
   Gdiplus::GraphicsPath path(&path_points_[0], &path_types_[0], path_types_.size(), 
     style().nonzero_fill_rule_ ? Gdiplus::FillModeWinding : Gdiplus::FillModeAlternate);
-  EffectivePaint fill = getEffectivePaint(style().fill_paint_);
-  if (boost::get<svgpp::tag::value::none>(&fill) == NULL)
+  if (filled)
   {
     if (color_t const * color = boost::get<color_t>(&fill))
-      graphics.FillPath(&Gdiplus::SolidBrush(Gdiplus::Color(style().fill_opacity_ * 255, 
+      graphics.FillPath(&Gdiplus::SolidBrush(Gdiplus::Color(style().fill_opacity_ * opacity * 255, 
         color->GetR(), color->GetG(), color->GetB())), &path);
     // TODO: gradient
   }
-  EffectivePaint stroke = getEffectivePaint(style().stroke_paint_);
-  if (boost::get<svgpp::tag::value::none>(&stroke) == NULL)
+  if (stroked)
   {
     if (color_t const * color = boost::get<color_t>(&stroke))
     {
-      Gdiplus::Pen pen(Gdiplus::Color(style().stroke_opacity_ * 255, 
+      Gdiplus::Pen pen(Gdiplus::Color(style().stroke_opacity_ * opacity * 255, 
           color->GetR(), color->GetG(), color->GetB()), 
         style().stroke_width_);
       pen.SetStartCap(style().line_cap_);
@@ -1472,31 +2062,38 @@ void Path::drawPath()
     return;
   path_.setFillType(style().nonzero_fill_rule_ ? SkPath::kWinding_FillType : SkPath::kEvenOdd_FillType);
 
-  SkCanvas canvas(getImageBuffer().bitmap());
-  canvas.setMatrix(transform());
   EffectivePaint fill = getEffectivePaint(style().fill_paint_);
-  if (boost::get<svgpp::tag::value::none>(&fill) == NULL)
+  EffectivePaint stroke = getEffectivePaint(style().stroke_paint_);
+  bool const filled = boost::get<svgpp::tag::value::none>(&fill) == NULL;
+  bool const stroked = boost::get<svgpp::tag::value::none>(&stroke) == NULL;
+  int folded_levels;
+  number_t const opacity = foldedPaintOpacity(filled, stroked, folded_levels);
+  ImageBuffer & buffer = getImageBuffer(deviceBounds(true), folded_levels);
+  SkCanvas canvas(buffer.bitmap());
+  SkMatrix device_transform = transform();
+  device_transform.postTranslate(-buffer.x(), -buffer.y());
+  canvas.setMatrix(device_transform);
+  if (filled)
   {
     SkPaint fillPaint;
     fillPaint.setAntiAlias(true);
     fillPaint.setStyle(SkPaint::kFill_Style);
     if (color_t const * color = boost::get<color_t>(&fill))
     {
-      fillPaint.setColor(SkColorSetA(*color, style().fill_opacity_ * 255));
+      fillPaint.setColor(SkColorSetA(*color, style().fill_opacity_ * opacity * 255));
     }
     else 
     {
-      fillPaint.setColor(SkColorSetA(0, style().fill_opacity_ * 255));
+      fillPaint.setColor(SkColorSetA(0, style().fill_opacity_ * opacity * 255));
       AssignGradientPaint(fillPaint, path_, boost::get<Gradient const>(fill), transform());
     }
 
     canvas.drawPath(path_, fillPaint);
   }
-  EffectivePaint stroke = getEffectivePaint(style().stroke_paint_);
-  if (boost::get<svgpp::tag::value::none>(&stroke) == NULL)
+  if (stroked)
   {
     SkPaint strokePaint = style().skPaintStroke_;
-    strokePaint.setAlpha(style().stroke_opacity_ * 255);
+    strokePaint.setAlpha(style().stroke_opacity_ * opacity * 255);
     std::vector<number_t> const & dasharray = style().stroke_dasharray_;
     if (!dasharray.empty())
     {
@@ -1507,11 +2104,11 @@ void Path::drawPath()
     }
     if (color_t const * color = boost::get<color_t>(&stroke))
     {
-      strokePaint.setColor(SkColorSetA(*color, style().stroke_opacity_ * 255));
+      strokePaint.setColor(SkColorSetA(*color, style().stroke_opacity_ * opacity * 255));
     }
     else
     {
-      strokePaint.setColor(SkColorSetA(0, style().stroke_opacity_ * 255));
+      strokePaint.setColor(SkColorSetA(0, style().stroke_opacity_ * opacity * 255));
       AssignGradientPaint(strokePaint, path_, boost::get<Gradient const>(stroke), transform());
     }
     canvas.drawPath(path_, strokePaint);
@@ -1658,11 +2255,22 @@ void renderDocument(XMLDocument & xmlDocument, ImageBuffer & buffer)
   document_traversal_main::load_document(xmlDocument.getRoot(), canvas);
 }
 
+bool ParseCompressionLevel(char const * str, int & level)
+{
+  char * end;
+  long const value = std::strtol(str, &end, 10);
+  if (end == str || *end != '\0' || value < 0 || value > 9)
+    return false;
+  level = int(value);
+  return true;
+}
+
 int main(int argc, char * argv[])
 {
-  if (argc < 2)
+  int compression_level = 6;
+  if (argc < 2 || (argc > 3 && !ParseCompressionLevel(argv[3], compression_level)))
   {
-    std::cout << "Usage: " << argv[0] << " <svg file name> [<output BMP file name>]\n";
+    std::cout << "Usage: " << argv[0] << " <svg file name> [<output PNG file name> [<PNG compression level 0-9>]]\n";
     return 1;
   }
 
@@ -1701,10 +2309,11 @@ int main(int argc, char * argv[])
     // Saving output
     const char * out_file_name = argc > 2 ? argv[2] : "svgpp.png";
 #if defined(RENDERER_AGG)
-    if (1 != stbi_write_png(out_file_name, buffer.pixfmt().width(), buffer.pixfmt().height(), 
+    PngWriteOptions const png_options(compression_level);
+    if (!writePng(out_file_name, buffer.pixfmt().width(), buffer.pixfmt().height(), 
       4, // RGBA
-      reinterpret_cast<const char *>(buffer.pixfmt().row_ptr(0)), 
-      buffer.pixfmt().stride()))
+      buffer.pixfmt().row_ptr(0), 
+      buffer.pixfmt().stride(), png_options))
     {
       std::cerr << "Error writing to PNG file\n";
       return 1;
@@ -0,0 +1,29 @@
+#include <svgpp/factory/color.hpp>
+#include <svgpp/factory/unitless_length.hpp>
+#include <svgpp/parser/external_function/parse_all_impl.hpp>
+
+// Instantiations for null-terminated narrow and wide strings (as used by rapidxml_ns policy) 
+// and default factories
+
+#define SVGPP_PARSE_ALL_IMPL(IteratorType) \
+  SVGPP_PARSE_PATH_DATA_IMPL(IteratorType, double) \
+  SVGPP_PARSE_PATH_DATA_IMPL(IteratorType, float) \
+  SVGPP_PARSE_TRANSFORM_IMPL(IteratorType, double) \
+  SVGPP_PARSE_TRANSFORM_IMPL(IteratorType, float) \
+  SVGPP_PARSE_PAINT_IMPL(IteratorType, svgpp::factory::color::default_factory, svgpp::factory::icc_color::default_factory) \
+  SVGPP_PARSE_COLOR_IMPL(IteratorType, svgpp::factory::color::default_factory, svgpp::factory::icc_color::default_factory) \
+  SVGPP_PARSE_PRESERVE_ASPECT_RATIO_IMPL(IteratorType) \
+  SVGPP_PARSE_MISC_IMPL(IteratorType, double) \
+  SVGPP_PARSE_MISC_IMPL(IteratorType, float) \
+  SVGPP_PARSE_CLIP_IMPL(IteratorType, svgpp::factory::length::default_factory) \
+  SVGPP_PARSE_LENGTH_IMPL(IteratorType, svgpp::factory::length::default_factory) \
+  SVGPP_PARSE_CLOCK_VALUE_IMPL(IteratorType, double) \
+  SVGPP_PARSE_CLOCK_VALUE_IMPL(IteratorType, float) \
+  SVGPP_PARSE_IRI_IMPL(IteratorType) \
+  SVGPP_PARSE_LIST_OF_NUMBERS_IMPL(IteratorType, double) \
+  SVGPP_PARSE_LIST_OF_NUMBERS_IMPL(IteratorType, float) \
+  SVGPP_PARSE_LIST_OF_POINTS_IMPL(IteratorType, double) \
+  SVGPP_PARSE_LIST_OF_POINTS_IMPL(IteratorType, float)
+
+SVGPP_PARSE_ALL_IMPL(char const *)
+SVGPP_PARSE_ALL_IMPL(wchar_t const *)
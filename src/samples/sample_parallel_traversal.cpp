@@ -0,0 +1,265 @@
+#include <rapidxml_ns/rapidxml_ns.hpp>
+#include <svgpp/policy/xml/rapidxml_ns.hpp>
+#include <svgpp/svgpp.hpp>
+#include <algorithm>
+#include <cmath>
+#include <future>
+#include <iostream>
+#include <limits>
+#include <string>
+#include <vector>
+
+// Calculates bounding box of document geometry. Large top-level groups are not
+// loaded by document_traversal itself, but are collected by document_traversal_control_policy
+// and loaded in parallel, each with its own context. Results are merged in document order.
+
+using namespace svgpp;
+
+typedef rapidxml_ns::xml_node<> const * xml_element_t;
+
+struct BoundingBox
+{
+  BoundingBox()
+    : x1(std::numeric_limits<double>::max())
+    , y1(std::numeric_limits<double>::max())
+    , x2(-std::numeric_limits<double>::max())
+    , y2(-std::numeric_limits<double>::max())
+  {}
+
+  void add_point(double x, double y)
+  {
+    x1 = std::min(x1, x); y1 = std::min(y1, y);
+    x2 = std::max(x2, x); y2 = std::max(y2, y);
+  }
+
+  // Merge hook, called for subtree results in document order
+  void merge(BoundingBox const & other)
+  {
+    if (other.x1 <= other.x2)
+    {
+      add_point(other.x1, other.y1);
+      add_point(other.x2, other.y2);
+    }
+  }
+
+  double x1, y1, x2, y2;
+};
+
+class Context
+{
+public:
+  Context(BoundingBox & bbox, std::vector<xml_element_t> * deferred_groups = NULL)
+    : bbox_(bbox)
+    , deferred_groups_(deferred_groups)
+  {
+    static const boost::array<double, 6> identity = {{ 1, 0, 0, 1, 0, 0 }};
+    transform_ = identity;
+  }
+
+  Context(Context const & parent)
+    : bbox_(parent.bbox_)
+    , transform_(parent.transform_)
+    , deferred_groups_(NULL)
+  {}
+
+  std::vector<xml_element_t> * deferred_groups() const { return deferred_groups_; }
+
+  void on_exit_element()
+  {}
+
+  void transform_matrix(const boost::array<double, 6> & matrix)
+  {
+    boost::array<double, 6> const m = transform_;
+    transform_[0] = m[0] * matrix[0] + m[2] * matrix[1];
+    transform_[1] = m[1] * matrix[0] + m[3] * matrix[1];
+    transform_[2] = m[0] * matrix[2] + m[2] * matrix[3];
+    transform_[3] = m[1] * matrix[2] + m[3] * matrix[3];
+    transform_[4] = m[0] * matrix[4] + m[2] * matrix[5] + m[4];
+    transform_[5] = m[1] * matrix[4] + m[3] * matrix[5] + m[5];
+  }
+
+  void path_move_to(double x, double y, tag::coordinate::absolute)
+  { add_point(x, y); }
+
+  void path_line_to(double x, double y, tag::coordinate::absolute)
+  { add_point(x, y); }
+
+  void path_cubic_bezier_to(
+    double x1, double y1,
+    double x2, double y2,
+    double x, double y,
+    tag::coordinate::absolute)
+  {
+    // Control points make the box conservative
+    add_point(x1, y1);
+    add_point(x2, y2);
+    add_point(x, y);
+  }
+
+  void path_quadratic_bezier_to(
+    double x1, double y1,
+    double x, double y,
+    tag::coordinate::absolute)
+  {
+    add_point(x1, y1);
+    add_point(x, y);
+  }
+
+  void path_close_subpath()
+  {}
+
+  void path_exit()
+  {}
+
+private:
+  BoundingBox & bbox_;
+  boost::array<double, 6> transform_;
+  std::vector<xml_element_t> * deferred_groups_;
+
+  void add_point(double x, double y)
+  {
+    bbox_.add_point(
+      transform_[0] * x + transform_[2] * y + transform_[4],
+      transform_[1] * x + transform_[3] * y + transform_[5]);
+  }
+};
+
+// Arcs are converted to cubic Bezier curves, so that control points bound them as well
+// (out-of-range radii are scaled up by the adapter as required by SVG)
+namespace svgpp { namespace policy { namespace path
+{
+  template<>
+  struct by_context<Context>
+  {
+    struct type: no_shorthands
+    {
+      static const bool arc_as_cubic_bezier = true;
+    };
+  };
+}}}
+
+struct ChildContextFactories
+{
+  template<class ParentContext, class ElementTag>
+  struct apply
+  {
+    typedef factory::context::on_stack<Context> type;
+  };
+};
+
+// Groups with more descendant elements than this are loaded in parallel
+static const size_t ParallelSubtreeThreshold = 1000;
+
+size_t CountElements(xml_element_t element, size_t limit)
+{
+  size_t count = 0;
+  for(xml_element_t child = element->first_node(); child && count <= limit; child = child->next_sibling())
+    if (child->type() == rapidxml_ns::node_element)
+      count += 1 + CountElements(child, limit - count);
+  return count;
+}
+
+struct DocumentTraversalControl: policy::document_traversal_control::stub<Context>
+{
+  static bool process_child(Context & context, xml_element_t xml_element)
+  {
+    // Only the root context has deferred_groups set
+    if (context.deferred_groups()
+      && detail::element_name_to_id_dictionary::find(
+        boost::iterator_range<const char *>(xml_element->local_name(), xml_element->local_name() + xml_element->local_name_size()))
+          == detail::element_type_id_g
+      && CountElements(xml_element, ParallelSubtreeThreshold) > ParallelSubtreeThreshold)
+    {
+      context.deferred_groups()->push_back(xml_element);
+      return false;
+    }
+    return true;
+  }
+};
+
+typedef
+  boost::mpl::set<
+    tag::element::svg,
+    tag::element::g,
+    tag::element::circle,
+    tag::element::ellipse,
+    tag::element::line,
+    tag::element::path,
+    tag::element::polygon,
+    tag::element::polyline,
+    tag::element::rect
+  >::type processed_elements_t;
+
+typedef
+  boost::mpl::insert<
+    traits::shapes_attributes_by_element,
+    tag::attribute::transform
+  >::type processed_attributes_t;
+
+typedef
+  document_traversal<
+    processed_elements<processed_elements_t>,
+    processed_attributes<processed_attributes_t>,
+    context_factories<ChildContextFactories>,
+    document_traversal_control_policy<DocumentTraversalControl>
+  > document_traversal_t;
+
+BoundingBox LoadGroup(xml_element_t xml_element)
+{
+  BoundingBox bbox;
+  Context context(bbox);
+  document_traversal_t::load_referenced_element<
+    expected_elements<boost::mpl::set1<tag::element::g> >
+  >::load(xml_element, context);
+  return bbox;
+}
+
+BoundingBox loadSvg(xml_element_t xml_root_element)
+{
+  BoundingBox bbox;
+  std::vector<xml_element_t> deferred_groups;
+  Context context(bbox, &deferred_groups);
+  document_traversal_t::load_document(xml_root_element, context);
+
+  std::vector<std::future<BoundingBox> > subtrees;
+  for(std::vector<xml_element_t>::const_iterator it = deferred_groups.begin(); it != deferred_groups.end(); ++it)
+    subtrees.push_back(std::async(std::launch::async, LoadGroup, *it));
+  for(size_t i = 0; i < subtrees.size(); ++i)
+    bbox.merge(subtrees[i].get());
+  return bbox;
+}
+
+int main()
+{
+  std::string text =
+    "<svg xmlns=\"http://www.w3.org/2000/svg\">"
+    " <rect x=\"10\" y=\"10\" width=\"20\" height=\"20\"/>";
+  for(int group = 0; group < 4; ++group)
+  {
+    text += "<g transform=\"translate(" + std::to_string(group * 100) + ")\">";
+    for(size_t i = 0; i <= ParallelSubtreeThreshold; ++i)
+      text += "<path d=\"M0 0 L50 " + std::to_string(i % 70) + "\"/>";
+    text += "</g>";
+  }
+  text += "</svg>";
+
+  std::vector<char> buffer(text.begin(), text.end());
+  buffer.push_back(0);
+  rapidxml_ns::xml_document<> doc;    // character type defaults to char
+  try
+  {
+    doc.parse<0>(&buffer[0]);
+    if (rapidxml_ns::xml_node<> * svg_element = doc.first_node("svg"))
+    {
+      BoundingBox bbox = loadSvg(svg_element);
+      std::cout << "Bounding box: " << bbox.x1 << " " << bbox.y1 << " " << bbox.x2 << " " << bbox.y2 << "\n";
+    }
+  }
+  catch (std::exception const & e)
+  {
+    std::cerr << "Error loading SVG: " << e.what() << std::endl;
+    return 1;
+  }
+
+  return 0;
+}
@@ -0,0 +1,175 @@
+#include <rapidxml_ns/rapidxml_ns.hpp>
+#include <svgpp/policy/xml/rapidxml_ns.hpp>
+#include <svgpp/svgpp.hpp>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <sstream>
+
+// Gets root 'svg' element size, viewBox and preserveAspectRatio. Input stream is read only up to
+// the end of root element start tag, only that start tag is passed to XML parser.
+
+using namespace svgpp;
+
+class SniffContext
+{
+public:
+  SniffContext()
+    : width_(0)
+    , height_(0)
+  {}
+
+  void set(tag::attribute::width, double val)
+  { width_ = val; }
+
+  void set(tag::attribute::height, double val)
+  { height_ = val; }
+
+  void set(tag::attribute::viewBox, double x, double y, double w, double h)
+  {
+    std::cout << "viewBox: " << x << " " << y << " " << w << " " << h << "\n";
+  }
+
+  void set(tag::attribute::preserveAspectRatio, bool defer, tag::value::none)
+  {
+    std::cout << "preserveAspectRatio: none\n";
+  }
+
+  template<class AlignTag, class MeetOrSliceTag>
+  void set(tag::attribute::preserveAspectRatio, bool defer, AlignTag, MeetOrSliceTag)
+  {
+    std::cout << "preserveAspectRatio: "
+      << (boost::is_same<MeetOrSliceTag, tag::value::meet>::value ? "meet" : "slice") << "\n";
+  }
+
+  double width_, height_;
+};
+
+typedef
+  boost::mpl::set<
+    tag::attribute::width,
+    tag::attribute::height,
+    tag::attribute::viewBox,
+    tag::attribute::preserveAspectRatio
+  >::type processed_attributes_t;
+
+typedef
+  document_traversal<
+    processed_elements<boost::mpl::set1<tag::element::svg>::type>,
+    processed_attributes<processed_attributes_t>
+  > document_traversal_t;
+
+// Skips prolog (XML declaration, comments, processing instructions, DOCTYPE) and returns start tag of
+// the root element as self-closing element. Stream isn't read past the start tag
+bool ReadRootStartTag(std::istream & in, std::string & start_tag)
+{
+  std::istreambuf_iterator<char> it(in), end;
+  for(;;)
+  {
+    for(; it != end && *it != '<'; ++it)
+    {}
+    if (it == end)
+      return false;
+    ++it;
+    if (it == end)
+      return false;
+    if (*it == '?')
+    {
+      // XML declaration or processing instruction
+      for(char prev = 0; it != end && !(prev == '?' && *it == '>'); prev = *it++)
+      {}
+    }
+    else if (*it == '!')
+    {
+      ++it;
+      if (it != end && *it == '-')
+      {
+        // Comment
+        for(int dashes = 0; it != end && !(dashes >= 2 && *it == '>'); ++it)
+          dashes = *it == '-' ? dashes + 1 : 0;
+      }
+      else
+      {
+        // DOCTYPE, may contain internal subset in square brackets
+        for(int depth = 0; it != end && !(depth == 0 && *it == '>'); ++it)
+          if (*it == '[')
+            ++depth;
+          else if (*it == ']')
+            --depth;
+      }
+    }
+    else
+      break;
+    if (it == end)
+      return false;
+    ++it;
+  }
+
+  start_tag = "<";
+  char quote = 0;
+  for(; it != end; ++it)
+  {
+    char const c = *it;
+    if (quote)
+    {
+      if (c == quote)
+        quote = 0;
+    }
+    else if (c == '"' || c == '\'')
+      quote = c;
+    else if (c == '>')
+    {
+      if (start_tag[start_tag.size() - 1] != '/')
+        start_tag += '/';
+      start_tag += '>';
+      return true;
+    }
+    start_tag += c;
+  }
+  return false;
+}
+
+int main(int argc, char * argv[])
+{
+  std::ifstream file;
+  std::istringstream sample(
+    "<?xml version=\"1.0\"?>\n"
+    "<!DOCTYPE svg PUBLIC \"-//W3C//DTD SVG 1.1//EN\" \"http://www.w3.org/Graphics/SVG/1.1/DTD/svg11.dtd\">\n"
+    "<!-- Size -> -->\n"
+    "<svg xmlns=\"http://www.w3.org/2000/svg\" width=\"640\" height=\"480\" viewBox=\"0 0 320 240\""
+    " preserveAspectRatio=\"xMidYMid slice\">"
+    "<rect width=\"20\" height=\"20\"/>" // Isn't read
+    "</svg>");
+  std::istream * in = &sample;
+  if (argc > 1)
+  {
+    file.open(argv[1], std::ios::binary);
+    in = &file;
+  }
+
+  std::string start_tag;
+  if (!ReadRootStartTag(*in, start_tag))
+  {
+    std::cerr << "Root element not found\n";
+    return 1;
+  }
+
+  try
+  {
+    rapidxml_ns::xml_document<> doc;
+    doc.parse<0>(&start_tag[0]);
+    if (rapidxml_ns::xml_node<> * svg_element = doc.first_node())
+    {
+      SniffContext context;
+      document_traversal_t::load_document_attributes(svg_element, context);
+      std::cout << "Size: " << context.width_ << " x " << context.height_ << "\n";
+    }
+  }
+  catch (std::exception const & e)
+  {
+    std::cerr << "Error: " << e.what() << std::endl;
+    return 1;
+  }
+
+  return 0;
+}
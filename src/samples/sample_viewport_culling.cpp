@@ -0,0 +1,456 @@
+#include <rapidxml_ns/rapidxml_ns.hpp>
+#include <svgpp/policy/xml/rapidxml_ns.hpp>
+#include <svgpp/svgpp.hpp>
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <limits>
+#include <map>
+#include <sstream>
+
+// Same document is processed for a number of tiles (viewports). Conservative bounds of each element are
+// calculated once by pre-pass over XML tree: shape bounds are taken from their geometry attributes,
+// path and points are parsed to bounding box only. During traversal for each tile
+// document_traversal_control_policy::process_child skips elements, that are outside of the tile.
+
+using namespace svgpp;
+
+typedef rapidxml_ns::xml_node<> const * xml_element_t;
+typedef boost::array<double, 6> matrix_t;
+
+static const matrix_t identity_matrix = {{ 1, 0, 0, 1, 0, 0 }};
+
+matrix_t multiply(matrix_t const & m, matrix_t const & matrix)
+{
+  matrix_t r;
+  r[0] = m[0] * matrix[0] + m[2] * matrix[1];
+  r[1] = m[1] * matrix[0] + m[3] * matrix[1];
+  r[2] = m[0] * matrix[2] + m[2] * matrix[3];
+  r[3] = m[1] * matrix[2] + m[3] * matrix[3];
+  r[4] = m[0] * matrix[4] + m[2] * matrix[5] + m[4];
+  r[5] = m[1] * matrix[4] + m[3] * matrix[5] + m[5];
+  return r;
+}
+
+struct Bounds
+{
+  Bounds()
+    : x1(std::numeric_limits<double>::max())
+    , y1(std::numeric_limits<double>::max())
+    , x2(-std::numeric_limits<double>::max())
+    , y2(-std::numeric_limits<double>::max())
+    , unbounded(false)
+  {}
+
+  static Bounds Unbounded()
+  {
+    Bounds b;
+    b.unbounded = true;
+    return b;
+  }
+
+  bool empty() const { return !unbounded && x1 > x2; }
+
+  void add_point(double x, double y)
+  {
+    x1 = std::min(x1, x); y1 = std::min(y1, y);
+    x2 = std::max(x2, x); y2 = std::max(y2, y);
+  }
+
+  void add(Bounds const & other)
+  {
+    unbounded = unbounded || other.unbounded;
+    if (!other.empty() && !other.unbounded)
+    {
+      add_point(other.x1, other.y1);
+      add_point(other.x2, other.y2);
+    }
+  }
+
+  Bounds transformed(matrix_t const & m) const
+  {
+    if (unbounded || empty())
+      return *this;
+    Bounds b;
+    double const xs[] = { x1, x2 }, ys[] = { y1, y2 };
+    for(int i = 0; i < 2; ++i)
+      for(int j = 0; j < 2; ++j)
+        b.add_point(
+          m[0] * xs[i] + m[2] * ys[j] + m[4],
+          m[1] * xs[i] + m[3] * ys[j] + m[5]);
+    return b;
+  }
+
+  bool intersects(Bounds const & other, double margin) const
+  {
+    if (unbounded || other.unbounded)
+      return true;
+    if (empty() || other.empty())
+      return false;
+    return x1 - margin <= other.x2 && other.x1 <= x2 + margin
+      && y1 - margin <= other.y2 && other.y1 <= y2 + margin;
+  }
+
+  double x1, y1, x2, y2;
+  bool unbounded; // Bounds can't be calculated cheaply
+};
+
+// Bounds pre-pass
+
+class PathBoundsContext
+{
+public:
+  PathBoundsContext(Bounds & bounds)
+    : bounds_(bounds)
+  {}
+
+  void path_move_to(double x, double y, tag::coordinate::absolute)
+  { bounds_.add_point(x, y); }
+
+  void path_line_to(double x, double y, tag::coordinate::absolute)
+  { bounds_.add_point(x, y); }
+
+  void path_cubic_bezier_to(
+    double x1, double y1,
+    double x2, double y2,
+    double x, double y,
+    tag::coordinate::absolute)
+  {
+    // Curve lies inside convex hull of control points
+    bounds_.add_point(x1, y1);
+    bounds_.add_point(x2, y2);
+    bounds_.add_point(x, y);
+  }
+
+  void path_quadratic_bezier_to(
+    double x1, double y1,
+    double x, double y,
+    tag::coordinate::absolute)
+  {
+    bounds_.add_point(x1, y1);
+    bounds_.add_point(x, y);
+  }
+
+  void path_close_subpath()
+  {}
+
+  void path_exit()
+  {}
+
+  template<class Range>
+  void set(tag::attribute::points, Range const & points)
+  {
+    for(typename boost::range_iterator<Range const>::type it = boost::begin(points); it != boost::end(points); ++it)
+      bounds_.add_point(it->first, it->second);
+  }
+
+private:
+  Bounds & bounds_;
+};
+
+// Arcs are converted to cubic Bezier curves, so that control points bound them as well
+// (out-of-range radii are scaled up by the adapter as required by SVG)
+namespace svgpp { namespace policy { namespace path
+{
+  template<>
+  struct by_context<PathBoundsContext>
+  {
+    struct type: no_shorthands
+    {
+      static const bool arc_as_cubic_bezier = true;
+    };
+  };
+}}}
+
+struct TransformContext
+{
+  TransformContext()
+    : matrix(identity_matrix)
+  {}
+
+  void transform_matrix(matrix_t const & m)
+  {
+    matrix = multiply(matrix, m);
+  }
+
+  matrix_t matrix;
+};
+
+typedef boost::iterator_range<const char *> string_range_t;
+
+string_range_t AttributeValue(xml_element_t element, const char * name)
+{
+  if (rapidxml_ns::xml_attribute<> const * attribute = element->first_attribute(name))
+    return string_range_t(attribute->value(), attribute->value() + attribute->value_size());
+  return string_range_t();
+}
+
+// Returns false if value has units other than 'px' (conversion would require viewport or font size)
+bool GetCoordinate(xml_element_t element, const char * name, double & value)
+{
+  std::string const str(boost::begin(AttributeValue(element, name)), boost::end(AttributeValue(element, name)));
+  char * end;
+  value = std::strtod(str.c_str(), &end);
+  std::string const units(end);
+  return units.empty() || units == "px";
+}
+
+typedef std::map<xml_element_t, Bounds> BoundsMap;
+
+// Calculates conservative bounds of element and its descendants in parent element coordinate system
+Bounds CalculateBounds(xml_element_t element, BoundsMap & bounds_map)
+{
+  Bounds bounds;
+  switch (detail::element_name_to_id_dictionary::find(
+    string_range_t(element->local_name(), element->local_name() + element->local_name_size())))
+  {
+  case detail::element_type_id_g:
+  case detail::element_type_id_svg:
+    for(xml_element_t child = element->first_node(); child; child = child->next_sibling())
+      if (child->type() == rapidxml_ns::node_element)
+        bounds.add(CalculateBounds(child, bounds_map));
+    // 'svg' establishes new viewport, its content isn't checked
+    if (element->local_name_size() == 3)
+      bounds = Bounds::Unbounded();
+    break;
+  case detail::element_type_id_rect:
+  {
+    double x = 0, y = 0, width = 0, height = 0;
+    if (GetCoordinate(element, "x", x) && GetCoordinate(element, "y", y)
+      && GetCoordinate(element, "width", width) && GetCoordinate(element, "height", height))
+    {
+      bounds.add_point(x, y);
+      bounds.add_point(x + width, y + height);
+    }
+    else
+      bounds = Bounds::Unbounded();
+    break;
+  }
+  case detail::element_type_id_circle:
+  case detail::element_type_id_ellipse:
+  {
+    double cx = 0, cy = 0, rx = 0, ry = 0;
+    bool const is_circle = element->local_name_size() == 6;
+    if (GetCoordinate(element, "cx", cx) && GetCoordinate(element, "cy", cy)
+      && GetCoordinate(element, is_circle ? "r" : "rx", rx) && GetCoordinate(element, is_circle ? "r" : "ry", ry))
+    {
+      bounds.add_point(cx - rx, cy - ry);
+      bounds.add_point(cx + rx, cy + ry);
+    }
+    else
+      bounds = Bounds::Unbounded();
+    break;
+  }
+  case detail::element_type_id_line:
+  {
+    double x1 = 0, y1 = 0, x2 = 0, y2 = 0;
+    if (GetCoordinate(element, "x1", x1) && GetCoordinate(element, "y1", y1)
+      && GetCoordinate(element, "x2", x2) && GetCoordinate(element, "y2", y2))
+    {
+      bounds.add_point(x1, y1);
+      bounds.add_point(x2, y2);
+    }
+    else
+      bounds = Bounds::Unbounded();
+    break;
+  }
+  case detail::element_type_id_path:
+  {
+    PathBoundsContext context(bounds);
+    value_parser<tag::type::path_data>::parse(tag::attribute::d(), context,
+      AttributeValue(element, "d"), tag::source::attribute());
+    break;
+  }
+  case detail::element_type_id_polyline:
+  case detail::element_type_id_polygon:
+  {
+    PathBoundsContext context(bounds);
+    value_parser<tag::attribute::points>::parse(tag::attribute::points(), context,
+      AttributeValue(element, "points"), tag::source::attribute());
+    break;
+  }
+  default:
+    bounds = Bounds::Unbounded();
+    break;
+  }
+
+  string_range_t transform = AttributeValue(element, "transform");
+  if (!boost::empty(transform))
+  {
+    TransformContext context;
+    value_parser<tag::type::transform_list>::parse(tag::attribute::transform(), context,
+      transform, tag::source::attribute());
+    bounds = bounds.transformed(context.matrix);
+  }
+
+  bounds_map[element] = bounds;
+  return bounds;
+}
+
+// Rendering
+
+class Context
+{
+public:
+  Context(BoundsMap const & bounds_map, Bounds const & viewport, size_t & shapes_processed)
+    : bounds_map_(bounds_map)
+    , viewport_(viewport)
+    , shapes_processed_(shapes_processed)
+    , transform_(identity_matrix)
+  {}
+
+  bool is_visible(xml_element_t element) const
+  {
+    BoundsMap::const_iterator it = bounds_map_.find(element);
+    return it == bounds_map_.end()
+      || it->second.transformed(transform_).intersects(viewport_, MaxStrokeWidth / 2);
+  }
+
+  void on_exit_element()
+  {}
+
+  void transform_matrix(const matrix_t & matrix)
+  {
+    transform_ = multiply(transform_, matrix);
+  }
+
+  void path_move_to(double x, double y, tag::coordinate::absolute)
+  {}
+
+  void path_line_to(double x, double y, tag::coordinate::absolute)
+  {}
+
+  void path_cubic_bezier_to(
+    double x1, double y1,
+    double x2, double y2,
+    double x, double y,
+    tag::coordinate::absolute)
+  {}
+
+  void path_quadratic_bezier_to(
+    double x1, double y1,
+    double x, double y,
+    tag::coordinate::absolute)
+  {}
+
+  void path_elliptical_arc_to(
+    double rx, double ry, double x_axis_rotation,
+    bool large_arc_flag, bool sweep_flag,
+    double x, double y,
+    tag::coordinate::absolute)
+  {}
+
+  void path_close_subpath()
+  {}
+
+  void path_exit()
+  {
+    // Shape would be rendered here
+    ++shapes_processed_;
+  }
+
+  // Bounds don't include stroke
+  static const int MaxStrokeWidth = 2;
+
+private:
+  BoundsMap const & bounds_map_;
+  Bounds const & viewport_;
+  size_t & shapes_processed_;
+  matrix_t transform_;
+};
+
+struct ChildContextFactories
+{
+  template<class ParentContext, class ElementTag>
+  struct apply
+  {
+    typedef factory::context::on_stack<Context> type;
+  };
+};
+
+struct DocumentTraversalControl: policy::document_traversal_control::stub<Context>
+{
+  static bool process_child(Context & context, xml_element_t xml_element)
+  {
+    return context.is_visible(xml_element);
+  }
+};
+
+typedef
+  boost::mpl::set<
+    tag::element::svg,
+    tag::element::g,
+    tag::element::circle,
+    tag::element::ellipse,
+    tag::element::line,
+    tag::element::path,
+    tag::element::polygon,
+    tag::element::polyline,
+    tag::element::rect
+  >::type processed_elements_t;
+
+typedef
+  boost::mpl::insert<
+    traits::shapes_attributes_by_element,
+    tag::attribute::transform
+  >::type processed_attributes_t;
+
+typedef
+  document_traversal<
+    processed_elements<processed_elements_t>,
+    processed_attributes<processed_attributes_t>,
+    context_factories<ChildContextFactories>,
+    basic_shapes_policy<policy::basic_shapes::all_to_path>,
+    document_traversal_control_policy<DocumentTraversalControl>
+  > document_traversal_t;
+
+int main()
+{
+  // 16 x 16 groups with 4 shapes each on 1024 x 1024 canvas
+  std::ostringstream text;
+  text << "<svg xmlns=\"http://www.w3.org/2000/svg\">";
+  for(int i = 0; i < 16; ++i)
+    for(int j = 0; j < 16; ++j)
+      text << "<g transform=\"translate(" << i * 64 << " " << j * 64 << ")\">"
+        << "<rect x=\"4\" y=\"4\" width=\"24\" height=\"24\"/>"
+        << "<circle cx=\"48\" cy=\"16\" r=\"12\"/>"
+        << "<line x1=\"4\" y1=\"36\" x2=\"28\" y2=\"60\"/>"
+        << "<path d=\"M36 36 h24 v24 a12 12 0 0 1 -24 0 z\"/>"
+        << "</g>";
+  text << "</svg>";
+  std::string const str = text.str();
+
+  std::vector<char> buffer(str.begin(), str.end());
+  buffer.push_back(0);
+  rapidxml_ns::xml_document<> doc;    // character type defaults to char
+  try
+  {
+    doc.parse<0>(&buffer[0]);
+    if (xml_element_t svg_element = doc.first_node("svg"))
+    {
+      BoundsMap bounds_map;
+      CalculateBounds(svg_element, bounds_map);
+
+      // 4 x 4 tiles
+      for(int i = 0; i < 4; ++i)
+        for(int j = 0; j < 4; ++j)
+        {
+          Bounds tile;
+          tile.add_point(i * 256, j * 256);
+          tile.add_point((i + 1) * 256, (j + 1) * 256);
+          size_t shapes_processed = 0;
+          Context context(bounds_map, tile, shapes_processed);
+          document_traversal_t::load_document(svg_element, context);
+          std::cout << "Tile " << i << "," << j << ": " << shapes_processed << " shapes\n";
+        }
+    }
+  }
+  catch (std::exception const & e)
+  {
+    std::cerr << "Error: " << e.what() << std::endl;
+    return 1;
+  }
+
+  return 0;
+}
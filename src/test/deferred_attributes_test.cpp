@@ -0,0 +1,149 @@
+#include <svgpp/document_traversal.hpp>
+#include <rapidxml_ns/rapidxml_ns.hpp>
+#include <svgpp/policy/xml/rapidxml_ns.hpp>
+#include <boost/bind.hpp>
+#include <boost/function.hpp>
+
+#include <gtest/gtest.h>
+
+#define TEXT(x) #x
+
+namespace
+{
+  class Context
+  {
+  public:
+    Context(bool parse_deferred)
+      : parse_deferred_(parse_deferred)
+      , deferred_count_(0)
+    {}
+
+    void on_enter_element(svgpp::tag::element::any const &) {}
+    void on_exit_element() const {}
+
+    template<class DeferredValue>
+    void set(svgpp::tag::attribute::d, DeferredValue const & value)
+    {
+      ++deferred_count_;
+      EXPECT_EQ(svgpp::detail::attribute_id_d, value.attribute_id());
+      if (parse_deferred_)
+      {
+        EXPECT_TRUE(value.parse(*this));
+      }
+      else
+        stored_.push_back(boost::bind(&DeferredValue::template parse<Context>, value, _1));
+    }
+
+    template<class DeferredValue>
+    void set(svgpp::tag::attribute::transform, DeferredValue const & value)
+    {
+      ++deferred_count_;
+      EXPECT_EQ("translate(1 2)", std::string(boost::begin(value.raw_value()), boost::end(value.raw_value())));
+      if (parse_deferred_)
+      {
+        EXPECT_TRUE(value.parse(*this));
+      }
+      else
+        stored_.push_back(boost::bind(&DeferredValue::template parse<Context>, value, _1));
+    }
+
+    void transform_matrix(const boost::array<double, 6> & matrix)
+    {
+      log_ << "matrix " << matrix[4] << "," << matrix[5] << ";";
+    }
+
+    void path_move_to(double x, double y, svgpp::tag::coordinate::absolute)
+    { log_ << "M" << x << "," << y << ";"; }
+
+    void path_line_to(double x, double y, svgpp::tag::coordinate::absolute)
+    { log_ << "L" << x << "," << y << ";"; }
+
+    void path_cubic_bezier_to(double, double, double, double, double, double, svgpp::tag::coordinate::absolute)
+    { log_ << "C;"; }
+
+    void path_quadratic_bezier_to(double, double, double, double, svgpp::tag::coordinate::absolute)
+    { log_ << "Q;"; }
+
+    void path_elliptical_arc_to(double, double, double, bool, bool, double, double, svgpp::tag::coordinate::absolute)
+    { log_ << "A;"; }
+
+    void path_close_subpath()
+    { log_ << "Z;"; }
+
+    void path_exit() {}
+
+    std::string str() const
+    {
+      return log_.str();
+    }
+
+    bool parse_deferred_;
+    int deferred_count_;
+    std::vector<boost::function<bool(Context &)> > stored_; // Deferred values kept if not parsed immediately
+
+  private:
+    std::ostringstream log_;
+  };
+
+  char const xml1[] =
+    TEXT(<svg xmlns="http://www.w3.org/2000/svg"><path transform="translate(1 2)" d="M10 10 h 10 v 10"/></svg>)
+    ;
+
+  void Load(Context & context)
+  {
+    std::vector<char> modified_xml(xml1, xml1 + strlen(xml1) + 1);
+    rapidxml_ns::xml_document<char> doc;
+    doc.parse<0>(&modified_xml[0]);
+    rapidxml_ns::xml_node<char> const * svg_element = doc.first_node();
+    ASSERT_TRUE(svg_element != NULL);
+    EXPECT_TRUE((
+      svgpp::document_traversal<
+        svgpp::processed_elements<
+          boost::mpl::set<
+            svgpp::tag::element::svg,
+            svgpp::tag::element::path
+          >::type
+        >,
+        svgpp::processed_attributes<
+          boost::mpl::set<
+            svgpp::tag::attribute::d,
+            svgpp::tag::attribute::transform
+          >::type
+        >,
+        svgpp::deferred_attributes<
+          boost::mpl::set<
+            svgpp::tag::attribute::d,
+            svgpp::tag::attribute::transform
+          >::type
+        >
+      >::load_document(svg_element, context)));
+    // Deferred values must not reference document text
+    std::fill(modified_xml.begin(), modified_xml.end(), ' ');
+  }
+}
+
+TEST(DeferredAttributes, NotParsed)
+{
+  Context context(false);
+  Load(context);
+  EXPECT_EQ(2, context.deferred_count_);
+  EXPECT_EQ("", context.str());
+}
+
+TEST(DeferredAttributes, Parsed)
+{
+  Context context(true);
+  Load(context);
+  EXPECT_EQ(2, context.deferred_count_);
+  EXPECT_EQ("M10,10;L20,10;L20,20;matrix 1,2;", context.str());
+}
+
+TEST(DeferredAttributes, ParsedAfterDocument)
+{
+  Context context(false);
+  Load(context);
+  ASSERT_EQ(2u, context.stored_.size());
+  for(size_t i = 0; i < context.stored_.size(); ++i)
+    EXPECT_TRUE(context.stored_[i](context));
+  EXPECT_EQ("M10,10;L20,10;L20,20;matrix 1,2;", context.str());
+}
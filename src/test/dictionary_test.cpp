@@ -54,6 +54,10 @@ TEST(Dictionary, CSSProperty)
   EXPECT_EQ(dict::find_ignore_case("baseline-shift"), svgpp::detail::attribute_id_baseline_shift);
   EXPECT_EQ(dict::find_ignore_case("baseline-shifT"), svgpp::detail::attribute_id_baseline_shift);
   EXPECT_EQ(dict::find_ignore_case(std::wstring(L"leTtEr-spacIng")), svgpp::detail::attribute_id_letter_spacing);
+  EXPECT_EQ(dict::find_ignore_case("FONT-SIZE"), svgpp::detail::attribute_id_font_size);
+  EXPECT_EQ(dict::find_ignore_case("font_size"), svgpp::detail::unknown_attribute_id);
+  EXPECT_EQ(dict::find_ignore_case("font-size "), svgpp::detail::unknown_attribute_id);
+  EXPECT_EQ(dict::find_ignore_case(L"Stroke-Width"), svgpp::detail::attribute_id_stroke_width);
 
 #define SVGPP_ON(name, str) EXPECT_EQ(svgpp::detail::unknown_attribute_id, dict::find(#str));
 #define SVGPP_ON_STYLE(name, str) EXPECT_EQ(svgpp::detail::attribute_id_ ## name, dict::find(#str));
@@ -61,6 +65,13 @@ TEST(Dictionary, CSSProperty)
 #undef SVGPP_ON
 #undef SVGPP_ON_STYLE
 
+#define SVGPP_ON(name, str) 
+#define SVGPP_ON_STYLE(name, str) EXPECT_EQ(svgpp::detail::attribute_id_ ## name, \
+  dict::find_ignore_case(boost::to_upper_copy(std::string(#str))));
+#include <svgpp/detail/dict/enumerate_all_attributes.inc>
+#undef SVGPP_ON
+#undef SVGPP_ON_STYLE
+
 #define SVGPP_ON(name, str) 
 #define SVGPP_ON_STYLE(name, str) EXPECT_EQ(boost::to_lower_copy(std::string(#str)), #str);
 #include <svgpp/detail/dict/enumerate_all_attributes.inc>
@@ -0,0 +1,161 @@
+#include <svgpp/attribute_traversal/attribute_traversal.hpp>
+#include <svgpp/document_traversal.hpp>
+#include <svgpp/parser/number.hpp>
+#include <svgpp/policy/error.hpp>
+#include <rapidxml_ns/rapidxml_ns.hpp>
+#include <svgpp/policy/xml/rapidxml_ns.hpp>
+
+#include <gtest/gtest.h>
+
+#define TEXT(x) #x
+
+namespace
+{
+  typedef rapidxml_ns::xml_node<char> const * xml_element_t;
+  typedef svgpp::diagnostics_log<xml_element_t> diagnostics_log_t;
+
+  struct Context
+  {
+    Context(diagnostics_log_t & log)
+      : log_(log)
+      , value_(0)
+    {}
+
+    diagnostics_log_t & diagnostics() const { return log_; }
+
+    void set(svgpp::tag::attribute::by, double val)
+    {
+      value_ = val;
+    }
+
+    diagnostics_log_t & log_;
+    double value_;
+  };
+
+  typedef svgpp::policy::error::collect<Context> error_policy_t;
+
+  struct DocumentContext
+  {
+    DocumentContext(diagnostics_log_t & log)
+      : log_(log)
+    {}
+
+    diagnostics_log_t & diagnostics() const { return log_; }
+
+    template<class ElementTag>
+    void on_enter_element(ElementTag) {}
+    void on_exit_element() {}
+
+    void set(svgpp::tag::attribute::opacity, double) {}
+    void set(svgpp::tag::attribute::opacity, svgpp::tag::value::inherit) {}
+
+    diagnostics_log_t & log_;
+  };
+
+  class traversal_context
+  {
+  public:
+    typedef Context context_type;
+
+    traversal_context(Context & context)
+      : context_(context)
+    {}
+
+    context_type & context()
+    {
+      return context_;
+    }
+
+    template<class Source>
+    bool load_attribute(svgpp::detail::attribute_id id, boost::iterator_range<char const *> const &, Source)
+    {
+      loaded_.push_back(id);
+      return true;
+    }
+
+    std::vector<svgpp::detail::attribute_id> loaded_;
+
+  private:
+    Context & context_;
+  };
+}
+
+TEST(error_policy_collect, parse_failed)
+{
+  diagnostics_log_t log;
+  Context ctx(log);
+  typedef svgpp::value_parser<svgpp::tag::type::number, svgpp::error_policy<error_policy_t> > parser_t;
+  EXPECT_TRUE(parser_t::parse(svgpp::tag::attribute::by(), ctx, std::string("1N8"), svgpp::tag::source::attribute()));
+  EXPECT_TRUE(parser_t::parse(svgpp::tag::attribute::by(), ctx, std::string("15"), svgpp::tag::source::attribute()));
+  EXPECT_EQ(15, ctx.value_);
+  ASSERT_EQ(1, log.entries().size());
+  EXPECT_EQ(svgpp::error_code::invalid_value, log.entries()[0].code);
+  EXPECT_EQ(svgpp::detail::attribute_id_by, log.entries()[0].attribute_id);
+  EXPECT_FALSE(log.entries()[0].element);
+  EXPECT_EQ("Invalid value of SVG attribute (or property) \"by\"", log.entries()[0].message());
+}
+
+TEST(error_policy_collect, unknown_attributes)
+{
+  char const xml[] =
+    TEXT(<svg x="1" unknown1="a" xmlns:inkscape="http://www.inkscape.org/namespaces/inkscape" inkscape:label="b" style="-inkscape-font-specification:c;fill:red" y="2"/>);
+  std::vector<char> modified_xml(xml, xml + strlen(xml) + 1);
+  rapidxml_ns::xml_document<char> doc;
+  doc.parse<0>(&modified_xml[0]);
+  xml_element_t svg_element = doc.first_node();
+  ASSERT_TRUE(svg_element != NULL);
+
+  diagnostics_log_t log;
+  Context ctx(log);
+  traversal_context context(ctx);
+  EXPECT_TRUE((svgpp::attribute_traversal<
+    svgpp::tag::element::svg,
+    svgpp::error_policy<error_policy_t>
+  >::type::load(svg_element->first_attribute(), context)));
+  EXPECT_EQ(3, context.loaded_.size());
+  ASSERT_EQ(2, log.entries().size());
+  EXPECT_EQ(svgpp::error_code::unknown_attribute, log.entries()[0].code);
+  EXPECT_EQ("Unknown attribute \"unknown1\"", log.entries()[0].message());
+  EXPECT_EQ(svgpp::error_code::unknown_css_property, log.entries()[1].code);
+  EXPECT_EQ("-inkscape-font-specification", log.entries()[1].name);
+}
+
+TEST(error_policy_collect, attribute_error_element)
+{
+  char const xml[] =
+    TEXT(<svg xmlns="http://www.w3.org/2000/svg"><g opacity="x" unknown1="a"/></svg>);
+  std::vector<char> modified_xml(xml, xml + strlen(xml) + 1);
+  rapidxml_ns::xml_document<char> doc;
+  doc.parse<0>(&modified_xml[0]);
+  xml_element_t svg_element = doc.first_node();
+  ASSERT_TRUE(svg_element != NULL);
+
+  diagnostics_log_t log;
+  DocumentContext ctx(log);
+  EXPECT_TRUE((svgpp::document_traversal<
+    svgpp::error_policy<svgpp::policy::error::collect<DocumentContext> >,
+    svgpp::processed_elements<boost::mpl::set2<svgpp::tag::element::svg, svgpp::tag::element::g> >,
+    svgpp::processed_attributes<boost::mpl::set1<svgpp::tag::attribute::opacity> >
+  >::load_document(svg_element, ctx)));
+  ASSERT_EQ(2, log.entries().size());
+  EXPECT_EQ(svgpp::error_code::unknown_attribute, log.entries()[0].code);
+  EXPECT_EQ(svgpp::error_code::invalid_value, log.entries()[1].code);
+  for(size_t i = 0; i < 2; ++i)
+  {
+    ASSERT_TRUE(log.entries()[i].element);
+    EXPECT_EQ(svg_element->first_node(), *log.entries()[i].element);
+  }
+}
+
+TEST(error_policy_collect, ring_buffer)
+{
+  diagnostics_log_t log(2);
+  Context ctx(log);
+  error_policy_t::negative_value(ctx, svgpp::tag::attribute::rx());
+  error_policy_t::negative_value(ctx, svgpp::tag::attribute::ry());
+  error_policy_t::required_attribute_not_found(ctx, svgpp::tag::attribute::width());
+  ASSERT_EQ(2, log.entries().size());
+  EXPECT_EQ(1, log.overwritten());
+  EXPECT_EQ(svgpp::detail::attribute_id_ry, log.entries()[0].attribute_id);
+  EXPECT_EQ("Required SVG attribute \"width\" not found", log.entries()[1].message());
+}
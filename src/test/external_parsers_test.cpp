@@ -0,0 +1,108 @@
+#define SVGPP_USE_EXTERNAL_CLOCK_VALUE_PARSER
+#define SVGPP_USE_EXTERNAL_IRI_PARSER
+#define SVGPP_USE_EXTERNAL_LIST_OF_NUMBERS_PARSER
+#define SVGPP_USE_EXTERNAL_LIST_OF_POINTS_PARSER
+
+#include <svgpp/parser/animation.hpp>
+#include <svgpp/parser/iri.hpp>
+#include <svgpp/parser/list_of_points.hpp>
+#include <svgpp/parser/number.hpp>
+
+#include <boost/range/as_literal.hpp>
+#include <gtest/gtest.h>
+
+namespace
+{
+  struct Context
+  {
+    void set(svgpp::tag::attribute::dur, double value)
+    {
+      log_ << value;
+    }
+
+    template<class AttributeTag, class Range>
+    void set(AttributeTag, Range const & iri)
+    {
+      log_ << std::string(boost::begin(iri), boost::end(iri));
+    }
+
+    template<class AttributeTag, class Range>
+    void set(AttributeTag, svgpp::tag::iri_fragment, Range const & fragment)
+    {
+      log_ << "#" << std::string(boost::begin(fragment), boost::end(fragment));
+    }
+
+    template<class Range>
+    void set(svgpp::tag::attribute::kernelMatrix, Range const & numbers)
+    {
+      for(typename boost::range_iterator<Range const>::type it = boost::begin(numbers); it != boost::end(numbers); ++it)
+        log_ << *it << ";";
+    }
+
+    template<class Range>
+    void set(svgpp::tag::attribute::points, Range const & points)
+    {
+      for(typename boost::range_iterator<Range const>::type it = boost::begin(points); it != boost::end(points); ++it)
+        log_ << it->first << "," << it->second << ";";
+    }
+
+    std::string str() const { return log_.str(); }
+
+  private:
+    std::ostringstream log_;
+  };
+
+  // Other tests instantiate grammars for std::string iterators with different configuration macros
+  template<class ValueType, class AttributeTag>
+  bool Parse(AttributeTag tag, Context & context, char const * value)
+  {
+    return svgpp::value_parser<ValueType>::parse(tag, context, boost::as_literal(value), svgpp::tag::source::attribute());
+  }
+}
+
+TEST(ExternalParsers, ClockValue)
+{
+  Context context;
+  EXPECT_TRUE(Parse<svgpp::tag::type::clock_value>(svgpp::tag::attribute::dur(), context, "01:30"));
+  EXPECT_EQ("90", context.str());
+}
+
+TEST(ExternalParsers, IRI)
+{
+  Context context;
+  EXPECT_TRUE(Parse<svgpp::tag::type::iri>(svgpp::tag::attribute::xlink::href(), context, "#a"));
+  EXPECT_TRUE(Parse<svgpp::tag::type::iri>(svgpp::tag::attribute::xlink::href(), context, "file.svg#c"));
+  EXPECT_TRUE(Parse<svgpp::tag::type::funciri>(svgpp::tag::attribute::mask(), context, "url(#b)"));
+  EXPECT_EQ("#afile.svg#c#b", context.str());
+}
+
+TEST(ExternalParsers, ListOfNumbers)
+{
+  Context context;
+  EXPECT_TRUE(Parse<svgpp::tag::type::list_of<svgpp::tag::type::number> >(
+    svgpp::tag::attribute::kernelMatrix(), context, "1 2,3 4.5"));
+  EXPECT_EQ("1;2;3;4.5;", context.str());
+
+  // Valid numbers are passed before error is reported
+  Context context2;
+  EXPECT_THROW(Parse<svgpp::tag::type::list_of<svgpp::tag::type::number> >(
+    svgpp::tag::attribute::kernelMatrix(), context2, "1 2,,3"), svgpp::exception_base);
+  EXPECT_EQ("1;2;", context2.str());
+}
+
+TEST(ExternalParsers, ListOfPoints)
+{
+  Context context;
+  EXPECT_TRUE(Parse<svgpp::tag::attribute::points>(svgpp::tag::attribute::points(), context, " 1,2 3-4 "));
+  EXPECT_EQ("1,2;3,-4;", context.str());
+}
+
+#include <svgpp/parser/external_function/parse_clock_value_impl.hpp>
+#include <svgpp/parser/external_function/parse_iri_impl.hpp>
+#include <svgpp/parser/external_function/parse_list_of_numbers_impl.hpp>
+#include <svgpp/parser/external_function/parse_list_of_points_impl.hpp>
+
+SVGPP_PARSE_CLOCK_VALUE_IMPL(char const *, double)
+SVGPP_PARSE_IRI_IMPL(char const *)
+SVGPP_PARSE_LIST_OF_NUMBERS_IMPL(char const *, double)
+SVGPP_PARSE_LIST_OF_POINTS_IMPL(char const *, double)
@@ -0,0 +1,133 @@
+#include <svgpp/parser/path_data.hpp>
+#include <svgpp/parser/transform_list.hpp>
+#include <svgpp/utility/calculate_viewbox_transform.hpp>
+#include <svgpp/utility/transform_points.hpp>
+
+#include <gtest/gtest.h>
+
+namespace
+{
+  struct FloatContext
+  {
+    void path_move_to(float x, float y, svgpp::tag::coordinate::absolute)
+    {
+      points_.push_back(x);
+      points_.push_back(y);
+    }
+
+    void path_line_to(float x, float y, svgpp::tag::coordinate::absolute)
+    {
+      points_.push_back(x);
+      points_.push_back(y);
+    }
+
+    void path_cubic_bezier_to(
+      float x1, float y1,
+      float x2, float y2,
+      float x, float y,
+      svgpp::tag::coordinate::absolute)
+    {
+      ++cubic_count_;
+      points_.push_back(x);
+      points_.push_back(y);
+    }
+
+    void path_close_subpath()
+    {}
+
+    void path_exit()
+    {}
+
+    void transform_matrix(const boost::array<float, 6> & matrix)
+    {
+      matrix_ = matrix;
+    }
+
+    FloatContext()
+      : cubic_count_(0)
+    {}
+
+    std::vector<float> points_;
+    int cubic_count_;
+    boost::array<float, 6> matrix_;
+  };
+}
+
+namespace svgpp
+{
+  template<>
+  struct number_type_by_context<FloatContext>
+  {
+    typedef float type;
+  };
+
+  namespace policy { namespace path
+  {
+    template<>
+    struct by_context<FloatContext>
+    {
+      typedef minimal type;
+    };
+  }}
+}
+
+TEST(FloatNumberType, Path)
+{
+  FloatContext context;
+  std::string const path("M10 20 q10 10 20 0 H50 a10 10 0 0 1 20 0 s5 5 10 0 z");
+  EXPECT_TRUE(svgpp::value_parser<svgpp::tag::type::path_data>::parse(svgpp::tag::attribute::d(), context,
+    path, svgpp::tag::source::attribute()));
+  // Half of circle is approximated by three cubic curves
+  ASSERT_EQ(14, context.points_.size());
+  EXPECT_EQ(5, context.cubic_count_);
+  float const expected[] = { 10, 20, 30, 20, 50, 20 };
+  for(int i = 0; i < 6; ++i)
+    EXPECT_FLOAT_EQ(expected[i], context.points_[i]);
+  EXPECT_NEAR(70, context.points_[10], 1e-4f);
+  EXPECT_NEAR(20, context.points_[11], 1e-4f);
+  EXPECT_NEAR(80, context.points_[12], 1e-4f);
+  EXPECT_NEAR(20, context.points_[13], 1e-4f);
+}
+
+TEST(FloatNumberType, Transform)
+{
+  FloatContext context;
+  std::string const transform("translate(10 20) scale(2)");
+  EXPECT_TRUE(svgpp::value_parser<svgpp::tag::type::transform_list>::parse(svgpp::tag::attribute::transform(), context,
+    transform, svgpp::tag::source::attribute()));
+  float const expected[] = { 2, 0, 0, 2, 10, 20 };
+  for(int i = 0; i < 6; ++i)
+    EXPECT_FLOAT_EQ(expected[i], context.matrix_[i]);
+}
+
+TEST(FloatNumberType, ViewboxTransform)
+{
+  float translate_x, translate_y, scale_x, scale_y;
+  svgpp::calculate_viewbox_transform<float>::calculate(200, 100, 10, 10, 50, 100,
+    svgpp::tag::value::xMidYMid(), svgpp::tag::value::meet(),
+    translate_x, translate_y, scale_x, scale_y);
+  EXPECT_FLOAT_EQ(1, scale_x);
+  EXPECT_FLOAT_EQ(1, scale_y);
+  EXPECT_FLOAT_EQ(65, translate_x);
+  EXPECT_FLOAT_EQ(-10, translate_y);
+}
+
+TEST(TransformPoints, SeparateArrays)
+{
+  boost::array<float, 6> const matrix = {{ 0, 1, -1, 0, 10, 20 }}; // rotate(90) then translate(10 20)
+  float x[] = { 1, 2, 3, 4, 5 };
+  float y[] = { 0, 0, 1, 1, -1 };
+  float x_out[5], y_out[5];
+  svgpp::transform_points(matrix, x, y, x_out, y_out, 5);
+  for(int i = 0; i < 5; ++i)
+  {
+    EXPECT_FLOAT_EQ(10 - y[i], x_out[i]);
+    EXPECT_FLOAT_EQ(20 + x[i], y_out[i]);
+  }
+  svgpp::transform_points(matrix, x, y, 5);
+  for(int i = 0; i < 5; ++i)
+  {
+    EXPECT_FLOAT_EQ(x_out[i], x[i]);
+    EXPECT_FLOAT_EQ(y_out[i], y[i]);
+  }
+}
@@ -21,6 +21,29 @@ struct Context
   pair_list_t values_;
 };
 
+struct FlatContext
+{
+  void set(svgpp::tag::attribute::points, boost::iterator_range<double const *> const & r)
+  {
+    ++calls_;
+    EXPECT_EQ(0, r.size() % 2);
+    for(double const * it = r.begin(); it != r.end(); it += 2)
+      values_.push_back(std::make_pair(it[0], it[1]));
+  }
+
+  FlatContext()
+    : calls_(0)
+  {}
+
+  int calls_;
+  pair_list_t values_;
+};
+
+typedef svgpp::value_parser<
+  svgpp::tag::attribute::points, 
+  svgpp::list_of_points_policy<svgpp::policy::list_of_points::flat_coordinates> 
+> flat_parser_t;
+
 typedef std::pair<const char *, pair_list_t> valid_case_t;
 
 using namespace boost::assign;
@@ -65,6 +88,19 @@ TEST_P(list_of_points_valid, valid)
   EXPECT_EQ(context.values_, GetParam().second);
 }
 
+TEST_P(list_of_points_valid, flat_coordinates)
+{
+  FlatContext context;
+  EXPECT_TRUE(flat_parser_t::parse(
+    svgpp::tag::attribute::points(),
+    context,
+    std::string(GetParam().first),
+    svgpp::tag::source::attribute()
+  ));
+  EXPECT_EQ(1, context.calls_);
+  EXPECT_EQ(context.values_, GetParam().second);
+}
+
 INSTANTIATE_TEST_CASE_P(value_parser,
                         list_of_points_valid,
                         ::testing::ValuesIn(valid_tests));
@@ -84,6 +120,17 @@ TEST_P(list_of_points_invalid, invalid)
   ), std::exception);
 }
 
+TEST_P(list_of_points_invalid, flat_coordinates)
+{
+  FlatContext context;
+  EXPECT_THROW(flat_parser_t::parse(
+    svgpp::tag::attribute::points(),
+    context,
+    std::string(GetParam()),
+    svgpp::tag::source::attribute()
+  ), std::exception);
+}
+
 INSTANTIATE_TEST_CASE_P(value_parser,
                         list_of_points_invalid,
                         ::testing::ValuesIn(invalid_tests));
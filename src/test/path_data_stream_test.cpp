@@ -0,0 +1,140 @@
+#include <svgpp/parser/path_data_stream.hpp>
+#include <svgpp/parser/grammar/path_data.hpp>
+#include <sstream>
+
+#include "test_path_context.hpp"
+
+#include <gtest/gtest.h>
+
+namespace
+{
+  const char * const paths[] = {
+    "",
+    "M300,200 100 200 h-150za150,151 0 1,0 150,-150z"
+      "M100,200 C100,100 250,100 250,200S400,300 400-200",
+    "M30.262 57.02L7.195 40.723c-5.84-3.976-7.56-12.06-3.842-18.063 3.715-6 11.467-7.65 17.306-3.68l4.52 3.76 2.6-5.274c3.717-6.002 11.47-7.65 17.305-3.68 5.84 3.97 7.56 12.054 3.842 18.062L34.49 56.118c-.897 1.512-2.793 1.915-4.228.9z",
+    "m1e2-1.5E-1 .5.5 q1 2 3 4 5 6 7 8 t1 2 3 4 T5 6 Q1 2 3 4 Vv h1,2 H3 v4 V5 zZ",
+    " \t\nM 1 2 \r\n L 3 , 4 , 5 6 s1 2 3 4 S5 6 7 8 a10 20 30 1 0 40 50 A10,20,30,0,1,40,50 a1 1 0 1140 50 ",
+    "M10 10 L20",
+    "M10 10 20 20 30",
+    "M10 10,",
+    "M,10 10",
+    "M10 10 L20 20,,30 30",
+    "L10 10",
+    "M10 10 z 5",
+    "M10 10 L",
+    "M1. 2",
+    "M1e 2",
+    "M1..5 2",
+    "M+1 -2 l+.5-.5",
+    "M10 10 a-1 1 0 0 0 1 1",
+    "M10 10 a1 1 0 2 0 1 1",
+    "M10 10 a1 1 0 0 0 1 1,",
+    "M10 10 Lz",
+    "M10 10 x",
+  };
+
+  std::string ParseWithGrammar(std::string const & path, bool & ok)
+  {
+    namespace qi = boost::spirit::qi;
+
+    std::string::const_iterator first = path.begin(), end = path.end();
+    test_path_context context;
+    svgpp::path_data_grammar<std::string::const_iterator, test_path_context> grammar;
+    ok = qi::phrase_parse(first, end, grammar(boost::phoenix::ref(context)), boost::spirit::ascii::space)
+      && first == end;
+    return context.str();
+  }
+
+  // Splits path at the given positions
+  std::string ParseByChunks(std::string const & path, std::vector<size_t> const & splits, bool & ok)
+  {
+    test_path_context context;
+    svgpp::path_data_stream_parser<test_path_context> parser(context);
+    ok = true;
+    size_t start = 0;
+    for(size_t i = 0; i <= splits.size(); ++i)
+    {
+      size_t const finish = i < splits.size() ? splits[i] : path.size();
+      if (ok)
+        ok = parser.parse_chunk(boost::make_iterator_range(path.begin() + start, path.begin() + finish));
+      start = finish;
+    }
+    ok = parser.finish() && ok;
+    return context.str();
+  }
+}
+
+TEST(path_data_stream_parser, SameAsGrammar)
+{
+  for(size_t i = 0; i < sizeof(paths) / sizeof(paths[0]); ++i)
+  {
+    std::string const path(paths[i]);
+    bool grammar_ok;
+    std::string const expected = ParseWithGrammar(path, grammar_ok);
+
+    bool ok;
+    EXPECT_EQ(expected, ParseByChunks(path, std::vector<size_t>(), ok)) << path;
+    EXPECT_EQ(grammar_ok, ok) << path;
+
+    // All two chunk splits
+    for(size_t split = 0; split <= path.size(); ++split)
+    {
+      EXPECT_EQ(expected, ParseByChunks(path, std::vector<size_t>(1, split), ok)) << path << " split at " << split;
+      EXPECT_EQ(grammar_ok, ok) << path << " split at " << split;
+    }
+
+    // One character chunks
+    std::vector<size_t> splits;
+    for(size_t split = 1; split < path.size(); ++split)
+      splits.push_back(split);
+    EXPECT_EQ(expected, ParseByChunks(path, splits, ok)) << path;
+    EXPECT_EQ(grammar_ok, ok) << path;
+  }
+}
+
+TEST(path_data_stream_parser, EventsForCompleteCommands)
+{
+  using namespace svgpp;
+
+  test_path_context context;
+  path_data_stream_parser<test_path_context> parser(context);
+  EXPECT_TRUE(parser.parse_chunk(std::string("M10 10 L20 2")));
+  EXPECT_EQ("M10,10", context.str());
+  EXPECT_TRUE(parser.parse_chunk(std::string("0 30")));
+  EXPECT_EQ("M10,10L20,20", context.str());
+  EXPECT_TRUE(parser.parse_chunk(std::string(" 40")));
+  // Number at the end of chunk may be continued in the next chunk
+  EXPECT_EQ("M10,10L20,20", context.str());
+  EXPECT_TRUE(parser.finish());
+  EXPECT_EQ("M10,10L20,20L30,40", context.str());
+}
+
+TEST(path_data_stream_parser, WideCharacters)
+{
+  using namespace svgpp;
+
+  {
+    test_path_context context;
+    path_data_stream_parser<test_path_context> parser(context);
+    EXPECT_TRUE(parser.parse_chunk(std::wstring(L"M10 10 L20 20")));
+    EXPECT_TRUE(parser.finish());
+    EXPECT_EQ("M10,10L20,20", context.str());
+  }
+  {
+    // Must not be truncated to 'M'
+    test_path_context context;
+    path_data_stream_parser<test_path_context> parser(context);
+    EXPECT_FALSE(parser.parse_chunk(std::wstring(L"\u014D10 10")));
+    EXPECT_FALSE(parser.finish());
+    EXPECT_EQ("", context.str());
+  }
+  {
+    // Must not be truncated to '1'
+    test_path_context context;
+    path_data_stream_parser<test_path_context> parser(context);
+    EXPECT_FALSE(parser.parse_chunk(std::wstring(L"M10 10 L\u0131\u0130 20")));
+    EXPECT_FALSE(parser.finish());
+    EXPECT_EQ("M10,10", context.str());
+  }
+}
@@ -42,6 +42,14 @@ namespace
       add(MarkerInstance(v, x, y, directionality), marker_index);
     }
 
+    void marker(svgpp::marker_vertex v, 
+      double x, double y, svgpp::policy::marker_directionality::unit_vector<>::direction const & direction, 
+      unsigned marker_index)
+    {
+      EXPECT_NEAR(1.0, direction.cos * direction.cos + direction.sin * direction.sin, 1e-8);
+      add(MarkerInstance(v, x, y, std::atan2(direction.sin, direction.cos)), marker_index);
+    }
+
     void marker(svgpp::marker_vertex v, 
       double x, double y, svgpp::tag::orient_fixed, unsigned marker_index)
     {
@@ -85,9 +93,10 @@ namespace
     MarkerSequence log_;
   };
 
+  template<class MarkersPolicy>
   void DoTest(Context & context, std::string const & path_string, MarkerSequence const & expected_markers)
   {
-    typedef svgpp::path_markers_adapter<Context> markers_adapter_t;
+    typedef svgpp::path_markers_adapter<Context, MarkersPolicy> markers_adapter_t;
     markers_adapter_t markers_adapter(context);
     //svgpp::path_adapter<markers_adapter_t, svgpp::path_policies_no_shorthands> path_adapter(markers_adapter);
     svgpp::value_parser<svgpp::tag::type::path_data>::parse(
@@ -139,7 +148,14 @@ namespace
             }
           }
 
-          DoTest(context, path_string, filtered_markers);
+          DoTest<svgpp::policy::markers::calculate>(context, path_string, filtered_markers);
+
+          Context unit_vector_context;
+          unit_vector_context.config_start_ = c[0];
+          unit_vector_context.config_mid_ = c[1];
+          unit_vector_context.config_end_ = c[2];
+          DoTest<svgpp::policy::markers::calculate_using<svgpp::policy::marker_directionality::unit_vector<> > >(
+            unit_vector_context, path_string, filtered_markers);
         }
   }
 }
@@ -213,3 +229,22 @@ TEST(path_markers_adapter, test6)
     (MarkerInstance(svgpp::marker_end, 10, 10, 0.0))
     );
 }
+
+TEST(path_markers_adapter, reversal)
+{
+  DoConfigTests("M0 0 h 10 h -10", list_of
+    (MarkerInstance(svgpp::marker_start, 0, 0, 0.0))
+    (MarkerInstance(svgpp::marker_mid, 10, 0, 90.0 * deg))
+    (MarkerInstance(svgpp::marker_end, 0, 0, 180.0 * deg))
+    );
+  DoConfigTests("M0 0 h -10 h 10", list_of
+    (MarkerInstance(svgpp::marker_start, 0, 0, 180.0 * deg))
+    (MarkerInstance(svgpp::marker_mid, -10, 0, 90.0 * deg))
+    (MarkerInstance(svgpp::marker_end, 0, 0, 0.0))
+    );
+  DoConfigTests("M0 0 v 10 v -10", list_of
+    (MarkerInstance(svgpp::marker_start, 0, 0, 90.0 * deg))
+    (MarkerInstance(svgpp::marker_mid, 0, 10, 0.0))
+    (MarkerInstance(svgpp::marker_end, 0, 0, -90.0 * deg))
+    );
+}
@@ -36,6 +36,17 @@ namespace
     std::ostringstream log_;
   };
 
+  void ExpectMarkers(Context const & context)
+  {
+    Context sample_context;
+    sample_context.marker(svgpp::marker_mid, 200, 200, 0, 1);
+    sample_context.marker(svgpp::marker_mid, 400, 0, -90 * boost::math::constants::degree<double>(), 2);
+    sample_context.marker(svgpp::marker_mid, 200, -200, -180 * boost::math::constants::degree<double>(), 3);
+    sample_context.marker(svgpp::marker_end, 0, 0, 135 * boost::math::constants::degree<double>(), 4);
+    sample_context.marker(svgpp::marker_start, 0, 0, 45 * boost::math::constants::degree<double>(), 0);
+    EXPECT_EQ(sample_context.str(), context.str());
+  }
+
   char const xml1[] = 
     TEXT(<svg xmlns="http://www.w3.org/2000/svg"><polyline points="0, 0 200, 200 400,0 200, -200 0, 0"/></svg>)
     ;
@@ -64,14 +75,32 @@ TEST(PolylineMarkers, Test1)
       >,
       svgpp::markers_policy<svgpp::policy::markers::calculate_always>
     >::load_document(svg_element, context)));
+  ExpectMarkers(context);
+}
 
-  {
-    Context sample_context;
-    sample_context.marker(svgpp::marker_mid, 200, 200, 0, 1);
-    sample_context.marker(svgpp::marker_mid, 400, 0, -90 * boost::math::constants::degree<double>(), 2);
-    sample_context.marker(svgpp::marker_mid, 200, -200, -180 * boost::math::constants::degree<double>(), 3);
-    sample_context.marker(svgpp::marker_end, 0, 0, 135 * boost::math::constants::degree<double>(), 4);
-    sample_context.marker(svgpp::marker_start, 0, 0, 45 * boost::math::constants::degree<double>(), 0);
-    EXPECT_EQ(sample_context.str(), context.str());
-  }
+TEST(PolylineMarkers, FlatCoordinates)
+{
+  std::vector<char> modified_xml(xml1, xml1 + strlen(xml1) + 1);
+  rapidxml_ns::xml_document<char> doc;
+  doc.parse<0>(&modified_xml[0]);  
+  rapidxml_ns::xml_node<char> const * svg_element = doc.first_node();
+  ASSERT_TRUE(svg_element != NULL);
+  Context context;
+  EXPECT_TRUE((
+    svgpp::document_traversal<
+      svgpp::processed_elements<
+        boost::mpl::set<
+          svgpp::tag::element::svg, 
+          svgpp::tag::element::polyline
+        >::type
+      >,
+      svgpp::processed_attributes<
+        boost::mpl::set<
+          svgpp::tag::attribute::points
+        >::type
+      >,
+      svgpp::markers_policy<svgpp::policy::markers::calculate_always>,
+      svgpp::list_of_points_policy<svgpp::policy::list_of_points::flat_coordinates>
+    >::load_document(svg_element, context)));
+  ExpectMarkers(context);
 }
\ No newline at end of file
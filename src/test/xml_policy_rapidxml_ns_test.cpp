@@ -0,0 +1,143 @@
+#include <rapidxml_ns/rapidxml_ns.hpp>
+#include <rapidxml_ns/rapidxml_ns_utils.hpp>
+#include <svgpp/policy/xml/rapidxml_ns.hpp>
+
+#include <gtest/gtest.h>
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace
+{
+  const char xml_ns[] = 
+    "<svg xmlns='http://www.w3.org/2000/svg' xmlns:l='http://www.w3.org/1999/xlink' xmlns:f='foreign'>"
+      "<f:g/>"
+      "<g xmlns='foreign'/>"
+      "<rect xml:space='preserve' l:href='#a' f:x='1' y='2'/>"
+    "</svg>";
+
+  typedef svgpp::policy::xml::element_iterator<rapidxml_ns::xml_node<char> const *> element_policy;
+  typedef svgpp::policy::xml::attribute_iterator<rapidxml_ns::xml_attribute<char> const *> attribute_policy;
+}
+
+TEST(RapidXMLNSPolicy, InternedNamespaces)
+{
+  std::vector<char> modified_xml(xml_ns, xml_ns + strlen(xml_ns) + 1);
+  rapidxml_ns::xml_document<char> doc;
+  doc.parse<0>(&modified_xml[0]);  
+  rapidxml_ns::xml_node<char> const * svg_element = doc.first_node();
+  ASSERT_TRUE(svg_element != NULL);
+  EXPECT_EQ(rapidxml_ns::svg_namespace<char>::uri(), svg_element->namespace_uri());
+
+  rapidxml_ns::xml_node<char> const * child = element_policy::get_child_elements(svg_element);
+  ASSERT_FALSE(element_policy::is_end(child));
+  EXPECT_EQ("rect", std::string(child->local_name(), child->local_name_size()));
+  element_policy::advance_element(child);
+  EXPECT_TRUE(element_policy::is_end(child));
+
+  rapidxml_ns::xml_attribute<char> const * attribute = svg_element->last_node()->first_attribute();
+  EXPECT_EQ(svgpp::detail::namespace_id::xml, attribute_policy::get_namespace(attribute));
+  attribute_policy::advance(attribute);
+  EXPECT_EQ(rapidxml_ns::xlink_namespace<char>::uri(), attribute->namespace_uri());
+  EXPECT_EQ(svgpp::detail::namespace_id::xlink, attribute_policy::get_namespace(attribute));
+  attribute_policy::advance(attribute);
+  EXPECT_EQ(svgpp::detail::namespace_id::other, attribute_policy::get_namespace(attribute));
+  attribute_policy::advance(attribute);
+  EXPECT_EQ(svgpp::detail::namespace_id::svg, attribute_policy::get_namespace(attribute));
+}
+
+namespace
+{
+  void dump_node(rapidxml_ns::xml_node<char> const * node, std::string & out)
+  {
+    out += "<" + std::string(node->name(), node->name_size()) + ">[" + std::string(node->value(), node->value_size()) + "]";
+    for(rapidxml_ns::xml_attribute<char> const * attribute = node->first_attribute(); attribute; attribute = attribute->next_attribute())
+      out += " " + std::string(attribute->name(), attribute->name_size()) 
+        + "=[" + std::string(attribute->value(), attribute->value_size()) + "]";
+    for(rapidxml_ns::xml_node<char> const * child = node->first_node(); child; child = child->next_sibling())
+      dump_node(child, out);
+    out += "</>";
+  }
+
+  template<int Flags>
+  std::string parse_and_dump(std::string const & xml, size_t offset)
+  {
+    // Offset shifts the text relative to 16-byte boundaries
+    std::vector<char> modified_xml(offset, ' ');
+    modified_xml.insert(modified_xml.end(), xml.begin(), xml.end());
+    modified_xml.push_back(0);
+    rapidxml_ns::xml_document<char> doc;
+    doc.parse<Flags>(&modified_xml[0] + offset);  
+    std::string out;
+    dump_node(doc.first_node(), out);
+    return out;
+  }
+
+  template<int Flags>
+  void check_simd_flag(std::string const & xml)
+  {
+    for(size_t offset = 0; offset < 32; ++offset)
+      EXPECT_EQ((parse_and_dump<Flags>(xml, offset)), (parse_and_dump<Flags | rapidxml_ns::parse_simd>(xml, offset)));
+  }
+}
+
+TEST(RapidXMLNS, SIMDFlag)
+{
+  std::string const xml = 
+    "<svg xmlns='http://www.w3.org/2000/svg'>\n"
+    "                                        \t\r\n"
+    "  <path d=\"M 10,20 L 30,40 C 1.5,2.5 3.5,4.5 5.5,6.5 C 1.5,2.5 3.5,4.5 5.5,6.5 C 1.5,2.5 3.5,4.5 5.5,6.5 z\" "
+    "title='it&apos;s a &quot;long&quot; attribute value with &amp; entities &#x41;&#66; and \"other\" quotes'/>"
+    "<text>Long text content with &lt;entities&gt; inside it and some more words after them</text>"
+    "<text>    text without entities that is long enough to span several sixteen byte blocks    </text>"
+    "<g  \t \n   a=''   b=\"\"/>"
+    "</svg>";
+  check_simd_flag<0>(xml);
+  check_simd_flag<rapidxml_ns::parse_no_string_terminators>(xml);
+  check_simd_flag<rapidxml_ns::parse_non_destructive>(xml);
+  check_simd_flag<rapidxml_ns::parse_trim_whitespace | rapidxml_ns::parse_normalize_whitespace>(xml);
+}
+
+namespace
+{
+  size_t pool_allocation_count = 0;
+
+  void * counting_allocate(std::size_t size)
+  {
+    ++pool_allocation_count;
+    return new char[size];
+  }
+
+  void counting_free(void * memory)
+  {
+    delete[] static_cast<char *>(memory);
+  }
+}
+
+TEST(RapidXMLNS, MemoryPoolReset)
+{
+  // Document that doesn't fit static memory of the pool
+  std::string xml = "<svg xmlns='http://www.w3.org/2000/svg'>";
+  for(int i = 0; i < 5000; ++i)
+    xml += "<rect x='1' y='2' width='3' height='4'/>";
+  xml += "</svg>";
+
+  rapidxml_ns::xml_document<char> doc;
+  doc.set_allocator(counting_allocate, counting_free);
+  std::vector<size_t> allocation_counts;
+  for(int i = 0; i < 4; ++i)
+  {
+    std::vector<char> modified_xml(xml.begin(), xml.end());
+    modified_xml.push_back(0);
+    doc.reset();
+    pool_allocation_count = 0;
+    doc.parse<0>(&modified_xml[0]);
+    ASSERT_TRUE(doc.first_node() != NULL);
+    EXPECT_EQ(5000u, rapidxml_ns::count_children(doc.first_node()));
+    allocation_counts.push_back(pool_allocation_count);
+  }
+  EXPECT_LT(0u, allocation_counts[0]);
+  EXPECT_EQ(0u, allocation_counts[1]);
+  EXPECT_EQ(0u, allocation_counts[2]);
+  EXPECT_EQ(0u, allocation_counts[3]);
+}
@@ -21,6 +21,16 @@
     #pragma warning(disable:4127)   // Conditional expression is constant
 #endif
 
+// Default namespace processor assigns single instances of SVG and XLink namespace URIs
+// (see svg_namespace and xlink_namespace), so that they can be compared as pointers
+#define RAPIDXML_NS_INTERNED_NAMESPACE_URIS
+
+// SSE2 implementation of parse_simd flag
+#if !defined(RAPIDXML_NS_NO_SSE2) && (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+    #define RAPIDXML_NS_SSE2
+    #include <emmintrin.h>
+#endif
+
 ///////////////////////////////////////////////////////////////////////////
 // RAPIDXML_PARSE_ERROR
     
@@ -257,6 +267,16 @@ namespace rapidxml_ns
     //! See xml_document::parse() function.
     const int parse_no_namespace = 0x1000;
 
+    //! Parse flag instructing the parser to use SSE2 instructions to skip whitespace, text and attribute values.
+    //! Parsing results are identical to the ones without the flag. 
+    //! Has effect only for 8-bit character type and when SSE2 is enabled in compiler, otherwise it is ignored.
+    //! Note that aligned 16-byte blocks containing the zero terminator are read up to their end.
+    //! This flag does not cause the parser to modify source text.
+    //! Can be combined with other flags by use of | operator.
+    //! <br><br>
+    //! See xml_document::parse() function.
+    const int parse_simd = 0x2000;
+
     // Compound flags
     
     //! Parse flags which represent default behaviour of the parser. 
@@ -338,6 +358,38 @@ namespace rapidxml_ns
         }
     };
 
+    template<class Ch>
+    struct svg_namespace
+    {
+        static const size_t uri_size = 26;
+
+        // Namespace processor replaces URIs equal to "http://www.w3.org/2000/svg" with this
+        // single zero-terminated instance, so that it can be compared as pointer
+        static Ch const * uri()
+        {
+            static const Ch value[uri_size + 1] = 
+                {'h', 't', 't', 'p', ':', '/', '/', 'w', 'w', 'w', '.', 'w', '3', '.', 'o', 'r', 'g', 
+                 '/', '2', '0', '0', '0', '/', 's', 'v', 'g', 0};
+            return value;
+        }
+    };
+
+    template<class Ch>
+    struct xlink_namespace
+    {
+        static const size_t uri_size = 28;
+
+        // Namespace processor replaces URIs equal to "http://www.w3.org/1999/xlink" with this
+        // single zero-terminated instance, so that it can be compared as pointer
+        static Ch const * uri()
+        {
+            static const Ch value[uri_size + 1] = 
+                {'h', 't', 't', 'p', ':', '/', '/', 'w', 'w', 'w', '.', 'w', '3', '.', 'o', 'r', 'g', 
+                 '/', '1', '9', '9', '9', '/', 'x', 'l', 'i', 'n', 'k', 0};
+            return value;
+        }
+    };
+
     ///////////////////////////////////////////////////////////////////////
     // Internals
 
@@ -409,6 +461,117 @@ namespace rapidxml_ns
             return true;
         }
 
+        // Returns single instance of well-known namespace URI equal to the given one, 
+        // or the given pointer if there is no such URI
+        template<class Ch>
+        inline Ch const * intern_namespace_uri(const Ch *uri, std::size_t uri_size)
+        {
+            if (compare(uri, uri_size, svg_namespace<Ch>::uri(), svg_namespace<Ch>::uri_size))
+                return svg_namespace<Ch>::uri();
+            if (compare(uri, uri_size, xlink_namespace<Ch>::uri(), xlink_namespace<Ch>::uri_size))
+                return xlink_namespace<Ch>::uri();
+            return uri;
+        }
+
+        // Character sets of predicates for vectorized skip (see parse_simd flag):
+        // simd_stop_chars - skip until zero terminator or any of C0..C2
+        // simd_accept_chars - skip while character is any of C0..C3
+        // simd_no_chars - vectorized skip isn't used
+        template<int C0, int C1 = C0, int C2 = C0>
+        struct simd_stop_chars {};
+
+        template<int C0, int C1 = C0, int C2 = C0, int C3 = C0>
+        struct simd_accept_chars {};
+
+        struct simd_no_chars {};
+
+        // Advances text to the first character that doesn't match Chars set or leaves it somewhere 
+        // before that character. Generic version does nothing
+        template<class Ch, class Chars>
+        struct simd_skipper
+        {
+            static void skip(Ch *&)
+            {
+            }
+        };
+
+#if defined(RAPIDXML_NS_SSE2)
+        inline unsigned first_set_bit(unsigned mask)
+        {
+#if defined(_MSC_VER)
+            unsigned long index;
+            _BitScanForward(&index, mask);
+            return index;
+#else
+            return __builtin_ctz(mask);
+#endif
+        }
+
+        template<int C0, int C1, int C2>
+        struct simd_skipper<char, simd_stop_chars<C0, C1, C2> >
+        {
+            static void skip(char *&text)
+            {
+                // Aligned loads never cross page boundary, so reading past the terminator is safe
+                char *p = text;
+                for (; reinterpret_cast<std::size_t>(p) & 15; ++p)
+                    if (*p == 0 || *p == char(C0) || *p == char(C1) || *p == char(C2))
+                    {
+                        text = p;
+                        return;
+                    }
+                const __m128i zero = _mm_setzero_si128();
+                const __m128i c0 = _mm_set1_epi8(char(C0));
+                const __m128i c1 = _mm_set1_epi8(char(C1));
+                const __m128i c2 = _mm_set1_epi8(char(C2));
+                for (;; p += 16)
+                {
+                    const __m128i chunk = _mm_load_si128(reinterpret_cast<const __m128i *>(p));
+                    const __m128i stop = _mm_or_si128(
+                        _mm_or_si128(_mm_cmpeq_epi8(chunk, zero), _mm_cmpeq_epi8(chunk, c0)),
+                        _mm_or_si128(_mm_cmpeq_epi8(chunk, c1), _mm_cmpeq_epi8(chunk, c2)));
+                    if (unsigned mask = static_cast<unsigned>(_mm_movemask_epi8(stop)))
+                    {
+                        text = p + first_set_bit(mask);
+                        return;
+                    }
+                }
+            }
+        };
+
+        template<int C0, int C1, int C2, int C3>
+        struct simd_skipper<char, simd_accept_chars<C0, C1, C2, C3> >
+        {
+            static void skip(char *&text)
+            {
+                // Most runs are short - check first characters before going to aligned loads
+                char *p = text;
+                for (; reinterpret_cast<std::size_t>(p) & 15; ++p)
+                    if (*p != char(C0) && *p != char(C1) && *p != char(C2) && *p != char(C3))
+                    {
+                        text = p;
+                        return;
+                    }
+                const __m128i c0 = _mm_set1_epi8(char(C0));
+                const __m128i c1 = _mm_set1_epi8(char(C1));
+                const __m128i c2 = _mm_set1_epi8(char(C2));
+                const __m128i c3 = _mm_set1_epi8(char(C3));
+                for (;; p += 16)
+                {
+                    const __m128i chunk = _mm_load_si128(reinterpret_cast<const __m128i *>(p));
+                    const __m128i accept = _mm_or_si128(
+                        _mm_or_si128(_mm_cmpeq_epi8(chunk, c0), _mm_cmpeq_epi8(chunk, c1)),
+                        _mm_or_si128(_mm_cmpeq_epi8(chunk, c2), _mm_cmpeq_epi8(chunk, c3)));
+                    if (unsigned mask = static_cast<unsigned>(_mm_movemask_epi8(accept)) ^ 0xFFFFu)
+                    {
+                        text = p + first_set_bit(mask);
+                        return;
+                    }
+                }
+            }
+        };
+#endif
+
         template<class Ch, class NamespaceStorage>
         void assign_element_namespace_uris(xml_node<Ch> * element, NamespaceStorage & ns_storage)
         {
@@ -467,6 +630,7 @@ namespace rapidxml_ns
                     : m_processor(processor)
                     , m_stack_position(processor.m_namespace_prefixes.size())
                     , m_default_namespace(0)
+                    , m_default_namespace_uri(0)
                 {
                 }
 
@@ -474,6 +638,7 @@ namespace rapidxml_ns
                     : m_processor(parent_scope.m_processor)
                     , m_stack_position(m_processor.m_namespace_prefixes.size())
                     , m_default_namespace(parent_scope.m_default_namespace)
+                    , m_default_namespace_uri(parent_scope.m_default_namespace_uri)
                 {
                 }
 
@@ -490,17 +655,20 @@ namespace rapidxml_ns
                 void set_default_namespace(xml_attribute<Ch> * ns_attr)
                 {
                     m_default_namespace = ns_attr;
+                    m_default_namespace_uri = intern_namespace_uri(ns_attr->value(), ns_attr->value_size());
                 }
 
                 void add_namespace_prefix(xml_attribute<Ch> * ns_attr)
                 {
-                    m_processor.m_namespace_prefixes.push_back(ns_attr);
+                    namespace_declaration const declaration = 
+                        { ns_attr, intern_namespace_uri(ns_attr->value(), ns_attr->value_size()) };
+                    m_processor.m_namespace_prefixes.push_back(declaration);
                 }
 
                 void set_element_default_namespace_uri(xml_node<Ch> * element) const
                 {
                     if (m_default_namespace)
-                        element->namespace_uri(m_default_namespace->value(), m_default_namespace->value_size());
+                        element->namespace_uri(m_default_namespace_uri, m_default_namespace->value_size());
                 }
 
                 void set_node_namespace_uri_by_prefix(xml_base<Ch> * node) const
@@ -510,9 +678,9 @@ namespace rapidxml_ns
                     for (typename xml_namespace_processor::xmlns_attributes_t::const_reverse_iterator 
                             it = m_processor.m_namespace_prefixes.rbegin();
                             it != m_processor.m_namespace_prefixes.rend(); ++it)
-                        if (compare((*it)->local_name(), (*it)->local_name_size(), prefix, prefix_size))
+                        if (compare(it->attribute->local_name(), it->attribute->local_name_size(), prefix, prefix_size))
                         {
-                            node->namespace_uri((*it)->value(), (*it)->value_size());
+                            node->namespace_uri(it->uri, it->attribute->value_size());
                             return;
                         }
                     RAPIDXML_PARSE_ERROR("No namespace definition found", 0);
@@ -522,10 +690,17 @@ namespace rapidxml_ns
                 xml_namespace_processor & m_processor;
                 size_t const m_stack_position;
                 xml_attribute<Ch> * m_default_namespace;
+                Ch const * m_default_namespace_uri;
             };
 
         private:
-            typedef std::vector<xml_attribute<Ch> *> xmlns_attributes_t;
+            struct namespace_declaration
+            {
+                xml_attribute<Ch> * attribute;
+                Ch const * uri;
+            };
+
+            typedef std::vector<namespace_declaration> xmlns_attributes_t;
             xmlns_attributes_t m_namespace_prefixes;
         };
 
@@ -599,7 +774,9 @@ namespace rapidxml_ns
         
         //! Constructs empty pool with default allocator functions.
         memory_pool()
-            : m_alloc_func(0)
+            : m_spare(0)
+            , m_spare_size(0)
+            , m_alloc_func(0)
             , m_free_func(0)
         {
             init();
@@ -738,12 +915,42 @@ namespace rapidxml_ns
             while (m_begin != m_static_memory)
             {
                 char *previous_begin = reinterpret_cast<header *>(align(m_begin))->previous_begin;
-                if (m_free_func)
-                    m_free_func(m_begin);
-                else
-                    delete[] m_begin;
+                free_raw(m_begin);
                 m_begin = previous_begin;
             }
+            if (m_spare)
+            {
+                free_raw(m_spare);
+                m_spare = 0;
+            }
+            init();
+        }
+
+        //! Resets the pool, keeping allocated memory for reuse. 
+        //! Dynamic memory blocks are merged into a single block that is used when static memory is exhausted, 
+        //! so pool that is repeatedly reset and filled with about the same amount of data stops allocating memory.
+        //! Any nodes or strings allocated from the pool will no longer be valid.
+        void reset()
+        {
+            std::size_t used_size = 0;
+            std::size_t block_count = 0;
+            for (char *block = m_begin; block != m_static_memory; ++block_count)
+            {
+                header *block_header = reinterpret_cast<header *>(align(block));
+                used_size += block_header->size;
+                block = block_header->previous_begin;
+            }
+            if (block_count == 1 && !m_spare)
+            {
+                m_spare = m_begin;
+                m_spare_size = used_size;
+            }
+            else if (block_count > 0)
+            {
+                clear();
+                m_spare = allocate_raw(used_size);
+                m_spare_size = used_size;
+            }
             init();
         }
 
@@ -762,7 +969,7 @@ namespace rapidxml_ns
         //! \param ff Free function, or 0 to restore default function
         void set_allocator(alloc_func *af, free_func *ff)
         {
-            assert(m_begin == m_static_memory && m_ptr == align(m_begin));    // Verify that no memory is allocated yet
+            assert(m_begin == m_static_memory && m_ptr == align(m_begin) && !m_spare);    // Verify that no memory is allocated yet
             m_alloc_func = af;
             m_free_func = ff;
         }
@@ -772,6 +979,7 @@ namespace rapidxml_ns
         struct header
         {
             char *previous_begin;
+            std::size_t size;
         };
 
         void init()
@@ -806,6 +1014,14 @@ namespace rapidxml_ns
             }
             return static_cast<char *>(memory);
         }
+
+        void free_raw(char *memory)
+        {
+            if (m_free_func)
+                m_free_func(memory);
+            else
+                delete[] memory;
+        }
         
         void *allocate_aligned(std::size_t size)
         {
@@ -822,12 +1038,22 @@ namespace rapidxml_ns
                 
                 // Allocate
                 std::size_t alloc_size = sizeof(header) + (2 * RAPIDXML_ALIGNMENT - 2) + pool_size;     // 2 alignments required in worst case: one for header, one for actual allocation
-                char *raw_memory = allocate_raw(alloc_size);
+                char *raw_memory;
+                if (m_spare && m_spare_size >= alloc_size)
+                {
+                    // Use memory kept by reset()
+                    raw_memory = m_spare;
+                    alloc_size = m_spare_size;
+                    m_spare = 0;
+                }
+                else
+                    raw_memory = allocate_raw(alloc_size);
                     
                 // Setup new pool in allocated memory
                 char *pool = align(raw_memory);
                 header *new_header = reinterpret_cast<header *>(pool);
                 new_header->previous_begin = m_begin;
+                new_header->size = alloc_size;
                 m_begin = raw_memory;
                 m_ptr = pool + sizeof(header);
                 m_end = raw_memory + alloc_size;
@@ -845,6 +1071,8 @@ namespace rapidxml_ns
         char *m_ptr;                                        // First free byte in current pool
         char *m_end;                                        // One past last available byte in current pool
         char m_static_memory[RAPIDXML_STATIC_POOL_SIZE];    // Static raw memory
+        char *m_spare;                                      // Memory block kept by reset() for reuse, or 0
+        std::size_t m_spare_size;                           // Size of spare memory block
         alloc_func *m_alloc_func;                           // Allocator function, or 0 if default is to be used
         free_func *m_free_func;                             // Free function, or 0 if default is to be used
     };
@@ -1778,6 +2006,7 @@ namespace rapidxml_ns
         //! <br><br>
         //! Document can be parsed into multiple times. 
         //! Each new call to parse removes previous nodes and attributes (if any), but does not clear memory pool.
+        //! Call reset() before parsing next document to reuse memory of the pool.
         //! \param text XML data to parse; pointer is non-const to denote fact that this data may be modified by the parser.
         template<int Flags>
         void parse(Ch *text)
@@ -1836,6 +2065,16 @@ namespace rapidxml_ns
             this->remove_all_attributes();
             memory_pool<Ch>::clear();
         }
+
+        //! Clears the document by deleting all nodes, but keeps memory of the pool for reuse
+        //! by next parse() call (see memory_pool::reset()).
+        //! All nodes owned by document pool are destroyed.
+        void reset()
+        {
+            this->remove_all_nodes();
+            this->remove_all_attributes();
+            memory_pool<Ch>::reset();
+        }
         
     private:
 
@@ -1845,6 +2084,8 @@ namespace rapidxml_ns
         // Detect whitespace character
         struct whitespace_pred
         {
+            typedef internal::simd_accept_chars<' ', '\n', '\r', '\t'> simd_chars;
+
             static unsigned char test(Ch ch)
             {
                 return internal::lookup_tables<0>::lookup_whitespace[static_cast<unsigned char>(ch)];
@@ -1854,6 +2095,8 @@ namespace rapidxml_ns
         // Detect node name character
         struct node_name_pred
         {
+            typedef internal::simd_no_chars simd_chars;
+
             static unsigned char test(Ch ch)
             {
                 return internal::lookup_tables<0>::lookup_node_name[static_cast<unsigned char>(ch)];
@@ -1863,6 +2106,8 @@ namespace rapidxml_ns
         // Detect node name character without ':' (NCName) - namespace prefix or local name
         struct node_ncname_pred
         {
+            typedef internal::simd_no_chars simd_chars;
+
             static unsigned char test(Ch ch)
             {
                 return internal::lookup_tables<0>::lookup_node_ncname[static_cast<unsigned char>(ch)];
@@ -1872,6 +2117,8 @@ namespace rapidxml_ns
         // Detect attribute name character
         struct attribute_name_pred
         {
+          typedef internal::simd_no_chars simd_chars;
+
           static unsigned char test(Ch ch)
           {
             return internal::lookup_tables<0>::lookup_attribute_name[static_cast<unsigned char>(ch)];
@@ -1881,6 +2128,8 @@ namespace rapidxml_ns
         // Detect attribute name character without ':' (NCName) - namespace prefix or local name
         struct attribute_ncname_pred
         {
+            typedef internal::simd_no_chars simd_chars;
+
             static unsigned char test(Ch ch)
             {
                 return internal::lookup_tables<0>::lookup_attribute_ncname[static_cast<unsigned char>(ch)];
@@ -1890,6 +2139,8 @@ namespace rapidxml_ns
         // Detect text character (PCDATA)
         struct text_pred
         {
+            typedef internal::simd_stop_chars<'<'> simd_chars;
+
             static unsigned char test(Ch ch)
             {
                 return internal::lookup_tables<0>::lookup_text[static_cast<unsigned char>(ch)];
@@ -1899,6 +2150,8 @@ namespace rapidxml_ns
         // Detect text character (PCDATA) that does not require processing
         struct text_pure_no_ws_pred
         {
+            typedef internal::simd_stop_chars<'<', '&'> simd_chars;
+
             static unsigned char test(Ch ch)
             {
                 return internal::lookup_tables<0>::lookup_text_pure_no_ws[static_cast<unsigned char>(ch)];
@@ -1908,6 +2161,8 @@ namespace rapidxml_ns
         // Detect text character (PCDATA) that does not require processing
         struct text_pure_with_ws_pred
         {
+            typedef internal::simd_no_chars simd_chars;
+
             static unsigned char test(Ch ch)
             {
                 return internal::lookup_tables<0>::lookup_text_pure_with_ws[static_cast<unsigned char>(ch)];
@@ -1918,6 +2173,8 @@ namespace rapidxml_ns
         template<Ch Quote>
         struct attribute_value_pred
         {
+            typedef internal::simd_stop_chars<Quote> simd_chars;
+
             static unsigned char test(Ch ch)
             {
                 if (Quote == Ch('\''))
@@ -1932,6 +2189,8 @@ namespace rapidxml_ns
         template<Ch Quote>
         struct attribute_value_pure_pred
         {
+            typedef internal::simd_stop_chars<Quote, '&'> simd_chars;
+
             static unsigned char test(Ch ch)
             {
                 if (Quote == Ch('\''))
@@ -1994,6 +2253,8 @@ namespace rapidxml_ns
         static void skip(Ch *&text)
         {
             Ch *tmp = text;
+            if (Flags & parse_simd)
+                internal::simd_skipper<Ch, typename StopPred::simd_chars>::skip(tmp);
             while (StopPred::test(*tmp))
                 ++tmp;
             text = tmp;